@@ -0,0 +1,340 @@
+#define _GNU_SOURCE
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <aoc/aoc.h>
+#include <aoc/mem.h>
+#include <aoc/bump.h>
+#include <aoc/arena.h>
+#include "../common/hash.h"
+#include "../common/hashstats.h"
+
+// microbenchmarks for the aocaux containers and allocators. prints the time
+// per operation and, where the kernel allows it, last level cache misses per
+// operation
+
+static inline uint32_t u32_hash(const uint32_t *const v) { return mix32(*v); }
+
+static inline bool u32_equals(const uint32_t *const a,
+                              const uint32_t *const b) {
+  return *a == *b;
+}
+
+static inline int u32_compare(const uint32_t *const a,
+                              const uint32_t *const b) {
+  return (*a > *b) - (*a < *b);
+}
+
+#define AOC_T uint32_t
+#define AOC_T_NAME U32
+#include <aoc/array.h>
+
+#define AOC_T uint32_t
+#define AOC_T_NAME U32
+#define AOC_T_EMPTY 0
+#define AOC_T_HFUNC u32_hash
+#define AOC_T_EQUALS u32_equals
+#define AOC_BASE2_CAPACITY
+#include <aoc/hashset.h>
+
+AOC_DEFINE_HASHSET_STATS(uint32_t, U32, u32_hash, u32_equals, 0)
+
+#define AOC_T uint32_t
+#define AOC_T_NAME U32
+#define AOC_T_COMPARE u32_compare
+#include <aoc/heap.h>
+
+#define AOC_T uint32_t
+#define AOC_T_NAME U32
+#define AOC_BASE2_CAPACITY
+#include <aoc/deque.h>
+#include "../common/frontier.h"
+
+AOC_DEFINE_FRONTIER(uint32_t, U32)
+
+#define OPERATIONS (1 << 20)
+#define HASHSET_CAPACITY (1 << 16)
+
+// keeps the compiler from dropping the measured work
+static volatile uint64_t sink;
+
+static int cacheMissCounter = -1;
+
+static void open_cache_miss_counter(void) {
+  struct perf_event_attr attr = {0};
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.size = sizeof(attr);
+  attr.config = PERF_COUNT_HW_CACHE_MISSES;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  cacheMissCounter = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+typedef struct {
+  struct timespec start;
+} measurement;
+
+static void measure_begin(measurement *const m) {
+  if (cacheMissCounter >= 0) {
+    ioctl(cacheMissCounter, PERF_EVENT_IOC_RESET, 0);
+    ioctl(cacheMissCounter, PERF_EVENT_IOC_ENABLE, 0);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &m->start);
+}
+
+static void measure_end(const measurement *const m, const char *const name,
+                        const size_t operations) {
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  const double ns = (double)(end.tv_sec - m->start.tv_sec) * 1e9 +
+                    (double)(end.tv_nsec - m->start.tv_nsec);
+
+  long long misses = -1;
+  if (cacheMissCounter >= 0) {
+    ioctl(cacheMissCounter, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(cacheMissCounter, &misses, sizeof(misses)) != sizeof(misses))
+      misses = -1;
+  }
+
+  if (misses >= 0)
+    printf("%-40s %10.2f ns/op %10.4f misses/op\n", name, ns / operations,
+           (double)misses / operations);
+  else
+    printf("%-40s %10.2f ns/op %10s misses/op\n", name, ns / operations, "-");
+}
+
+static inline uint32_t xorshift32(uint32_t *const state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+typedef enum {
+  KEYS_SEQUENTIAL,
+  KEYS_RANDOM,
+  KEYS_STRIDED,
+} key_distribution;
+
+static const char *const distributionNames[] = {"sequential", "random",
+                                                "strided"};
+
+static void generate_keys(uint32_t *const keys, const size_t count,
+                          const key_distribution distribution,
+                          uint32_t seed) {
+  // keys are never 0, that is the empty slot of the hashset
+  for (size_t i = 0; i < count; ++i) {
+    switch (distribution) {
+    case KEYS_SEQUENTIAL:
+      keys[i] = (uint32_t)i + seed;
+      break;
+    case KEYS_RANDOM:
+      keys[i] = xorshift32(&seed) | 1;
+      break;
+    case KEYS_STRIDED:
+      // only the high bits differ, like packed coordinates do
+      keys[i] = ((uint32_t)i + seed) << 12;
+      break;
+    }
+  }
+}
+
+static void bench_array(void) {
+  measurement m;
+  AocArrayU32 array = {0};
+  AocArrayU32Create(&array, 1);
+  measure_begin(&m);
+  for (uint32_t i = 0; i < OPERATIONS; ++i)
+    AocArrayU32Push(&array, i);
+  measure_end(&m, "array push with growth", OPERATIONS);
+
+  AocArrayU32Clear(&array);
+  measure_begin(&m);
+  for (uint32_t i = 0; i < OPERATIONS; ++i)
+    AocArrayU32Push(&array, i);
+  measure_end(&m, "array push without growth", OPERATIONS);
+  sink += array.items[array.length - 1];
+  AocArrayU32Destroy(&array);
+}
+
+static void bench_hashset(const key_distribution distribution,
+                          const double loadFactor) {
+  const size_t count = (size_t)(HASHSET_CAPACITY * loadFactor);
+  uint32_t *const keys = AocAlloc(sizeof(uint32_t) * count);
+  uint32_t *const missing = AocAlloc(sizeof(uint32_t) * count);
+  generate_keys(keys, count, distribution, 1);
+  generate_keys(missing, count, distribution, (uint32_t)count + 1);
+
+  AocHashsetU32 set = {0};
+  AocHashsetU32Create(&set, HASHSET_CAPACITY);
+
+  char name[64];
+  measurement m;
+  snprintf(name, sizeof(name), "hashset insert %s %.2f",
+           distributionNames[distribution], loadFactor);
+  measure_begin(&m);
+  for (size_t i = 0; i < count; ++i) {
+    uint32_t hash = 0;
+    if (!AocHashsetU32Contains(&set, keys[i], &hash))
+      AocHashsetU32InsertPreHashed(&set, keys[i], hash);
+  }
+  measure_end(&m, name, count);
+
+  const aoc_hashset_stats stats = AocHashsetU32Stats(&set);
+  AocHashsetStatsPrint(stdout, name, &stats);
+
+  size_t found = 0;
+  snprintf(name, sizeof(name), "hashset lookup hit %s %.2f",
+           distributionNames[distribution], loadFactor);
+  measure_begin(&m);
+  for (size_t i = 0; i < count; ++i)
+    found += AocHashsetU32Contains(&set, keys[i], NULL);
+  measure_end(&m, name, count);
+
+  snprintf(name, sizeof(name), "hashset lookup miss %s %.2f",
+           distributionNames[distribution], loadFactor);
+  measure_begin(&m);
+  for (size_t i = 0; i < count; ++i)
+    found += AocHashsetU32Contains(&set, missing[i], NULL);
+  measure_end(&m, name, count);
+  sink += found;
+
+  AocHashsetU32Destroy(&set);
+  AocFree(missing);
+  AocFree(keys);
+}
+
+static void bench_heap(void) {
+  uint32_t *const keys = AocAlloc(sizeof(uint32_t) * OPERATIONS);
+  generate_keys(keys, OPERATIONS, KEYS_RANDOM, 7);
+
+  AocMinHeapU32 heap = {0};
+  AocMinHeapU32Create(&heap, OPERATIONS);
+  measurement m;
+  measure_begin(&m);
+  for (size_t i = 0; i < OPERATIONS; ++i)
+    AocMinHeapU32Push(&heap, keys[i]);
+  measure_end(&m, "heap push random", OPERATIONS);
+
+  uint64_t sum = 0;
+  measure_begin(&m);
+  while (heap.count > 0)
+    sum += AocMinHeapU32Pop(&heap);
+  measure_end(&m, "heap pop", OPERATIONS);
+  sink += sum;
+
+  AocMinHeapU32Destroy(&heap);
+  AocFree(keys);
+}
+
+static void bench_deque(void) {
+  AocDequeU32 deque = {0};
+  AocDequeU32Create(&deque, 1 << 10);
+  uint64_t sum = 0;
+  measurement m;
+
+  measure_begin(&m);
+  for (uint32_t i = 0; i < OPERATIONS; ++i)
+    AocDequeU32PushBack(&deque, i);
+  measure_end(&m, "deque push back", OPERATIONS);
+
+  measure_begin(&m);
+  for (uint32_t i = 0; i < OPERATIONS; ++i)
+    sum += AocDequeU32PopFront(&deque);
+  measure_end(&m, "deque pop front", OPERATIONS);
+
+  measure_begin(&m);
+  for (uint32_t i = 0; i < OPERATIONS; ++i)
+    AocDequeU32PushFront(&deque, i);
+  measure_end(&m, "deque push front", OPERATIONS);
+
+  measure_begin(&m);
+  for (uint32_t i = 0; i < OPERATIONS; ++i)
+    sum += AocDequeU32PopBack(&deque);
+  measure_end(&m, "deque pop back", OPERATIONS);
+
+  // a breadth first search frontier stays small and cycles through the ring
+  measure_begin(&m);
+  AocDequeU32PushBack(&deque, 0);
+  for (uint32_t i = 0; i < OPERATIONS; ++i) {
+    sum += AocDequeU32PopFront(&deque);
+    AocDequeU32PushBack(&deque, i);
+  }
+  measure_end(&m, "deque frontier pop front + push back", OPERATIONS);
+  sink += sum;
+
+  AocDequeU32Destroy(&deque);
+}
+
+static void bench_allocations(const char *const name, const size_t size) {
+  // touch every allocation so untouched memory does not look free
+  measurement m;
+  measure_begin(&m);
+  for (size_t i = 0; i < OPERATIONS; ++i) {
+    char *const p = AocAlloc(size);
+    p[0] = (char)i;
+    sink += (uint64_t)p[0];
+  }
+  measure_end(&m, name, OPERATIONS);
+}
+
+static void bench_allocators(void) {
+  void **const pointers = malloc(sizeof(void *) * OPERATIONS);
+  measurement m;
+  measure_begin(&m);
+  for (size_t i = 0; i < OPERATIONS; ++i) {
+    pointers[i] = malloc(32);
+    ((char *)pointers[i])[0] = (char)i;
+  }
+  for (size_t i = 0; i < OPERATIONS; ++i)
+    free(pointers[i]);
+  measure_end(&m, "malloc + free 32 bytes", OPERATIONS);
+  free(pointers);
+
+  // both allocators get enough memory for every allocation plus alignment
+  aoc_bump bump = {0};
+  AocBumpInit(&bump, (size_t)OPERATIONS * 64);
+  aoc_allocator bumpAllocator = AocBumpCreateAllocator(&bump);
+  AocMemSetAllocator(&bumpAllocator);
+  bench_allocations("bump alloc 32 bytes", 32);
+  AocBumpDestroy(&bump);
+
+  aoc_arena arena = {0};
+  AocArenaAlloc(&arena, (size_t)OPERATIONS * 64);
+  AocArenaReset(&arena);
+  aoc_allocator arenaAllocator = AocArenaCreateAllocator(&arena);
+  AocMemSetAllocator(&arenaAllocator);
+  bench_allocations("arena alloc 32 bytes", 32);
+  AocArenaFree(&arena);
+}
+
+int main(void) {
+  open_cache_miss_counter();
+  if (cacheMissCounter < 0)
+    fprintf(stderr, "cache miss counter unavailable, check "
+                    "/proc/sys/kernel/perf_event_paranoid\n");
+
+  bench_array();
+
+  static const double loadFactors[] = {0.25, 0.5, 0.7};
+  for (int d = KEYS_SEQUENTIAL; d <= KEYS_STRIDED; ++d) {
+    for (size_t i = 0; i < sizeof(loadFactors) / sizeof(loadFactors[0]); ++i)
+      bench_hashset((key_distribution)d, loadFactors[i]);
+  }
+
+  bench_heap();
+  bench_deque();
+
+  // changes the global allocator, so it runs last
+  bench_allocators();
+
+  if (cacheMissCounter >= 0)
+    close(cacheMissCounter);
+}
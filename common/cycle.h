@@ -0,0 +1,62 @@
+#ifndef COMMON_CYCLE_H
+#define COMMON_CYCLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <aoc/mem.h>
+
+typedef void (*aoc_cycle_step_func)(void *state);
+typedef bool (*aoc_cycle_equals_func)(const void *a, const void *b);
+
+typedef struct {
+  size_t start;
+  size_t length;
+} aoc_cycle;
+
+// brent's cycle detection for the sequence initial, step(initial), ... over
+// an opaque state of `size` bytes. states are copied with memcpy, so they must
+// not own memory. `first` receives the first state of the cycle
+static inline aoc_cycle AocFindCycle(const void *const initial,
+                                     void *const first, const size_t size,
+                                     const aoc_cycle_step_func step,
+                                     const aoc_cycle_equals_func equals) {
+  void *const tortoise = first;
+  void *const hare = AocAlloc(size);
+
+  // the tortoise waits at every power of two while the hare runs ahead until
+  // they meet. the distance is the cycle length
+  memcpy(tortoise, initial, size);
+  memcpy(hare, initial, size);
+  step(hare);
+  size_t power = 1;
+  size_t length = 1;
+  while (!equals(tortoise, hare)) {
+    if (power == length) {
+      memcpy(tortoise, hare, size);
+      power *= 2;
+      length = 0;
+    }
+    step(hare);
+    length++;
+  }
+
+  // start both from the beginning with the hare one cycle ahead. they meet at
+  // the first state of the cycle
+  memcpy(tortoise, initial, size);
+  memcpy(hare, initial, size);
+  for (size_t i = 0; i < length; ++i)
+    step(hare);
+  size_t start = 0;
+  while (!equals(tortoise, hare)) {
+    step(tortoise);
+    step(hare);
+    start++;
+  }
+
+  AocFree(hare);
+  return (aoc_cycle){.start = start, .length = length};
+}
+
+#endif
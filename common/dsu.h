@@ -0,0 +1,71 @@
+#ifndef COMMON_DSU_H
+#define COMMON_DSU_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <aoc/mem.h>
+
+// disjoint set over the elements 0 to size - 1 with path halving and union by
+// rank. `type` is the index type, count is the number of disjoint sets left
+#define AOC_DEFINE_DSU(type, name)                                             \
+  typedef struct {                                                             \
+    type *parents;                                                             \
+    uint8_t *ranks;                                                            \
+    size_t count;                                                              \
+  } AocDsu##name;                                                              \
+                                                                               \
+  static inline void AocDsu##name##Create(AocDsu##name *const set,             \
+                                          const size_t size) {                 \
+    set->parents = AocAlloc(sizeof(type) * size);                              \
+    set->ranks = AocCalloc(size, sizeof(uint8_t));                             \
+    set->count = size;                                                         \
+    for (size_t i = 0; i < size; ++i)                                          \
+      set->parents[i] = (type)i;                                               \
+  }                                                                            \
+                                                                               \
+  static inline void AocDsu##name##Destroy(AocDsu##name *const set) {          \
+    AocFree(set->parents);                                                     \
+    AocFree(set->ranks);                                                       \
+  }                                                                            \
+                                                                               \
+  static inline type AocDsu##name##Find(AocDsu##name *const set, type i) {     \
+    /* path halving: every visited node skips to its grandparent */            \
+    while (set->parents[i] != i) {                                             \
+      set->parents[i] = set->parents[set->parents[i]];                         \
+      i = set->parents[i];                                                     \
+    }                                                                          \
+    return i;                                                                  \
+  }                                                                            \
+                                                                               \
+  static inline bool AocDsu##name##Union(AocDsu##name *const set,              \
+                                         const type a, const type b) {         \
+    type rootA = AocDsu##name##Find(set, a);                                   \
+    type rootB = AocDsu##name##Find(set, b);                                   \
+    if (rootA == rootB)                                                        \
+      return false;                                                            \
+    /* attach the shallower tree below the deeper one */                       \
+    if (set->ranks[rootA] < set->ranks[rootB]) {                               \
+      const type tmp = rootA;                                                  \
+      rootA = rootB;                                                           \
+      rootB = tmp;                                                             \
+    }                                                                          \
+    set->parents[rootB] = rootA;                                               \
+    if (set->ranks[rootA] == set->ranks[rootB])                                \
+      set->ranks[rootA]++;                                                     \
+    set->count--;                                                              \
+    return true;                                                               \
+  }                                                                            \
+                                                                               \
+  /* merges a[i] with b[i] for every pair. returns how many merges happened */ \
+  static inline size_t AocDsu##name##UnionBatch(                               \
+      AocDsu##name *const set, const type *const a, const type *const b,       \
+      const size_t count) {                                                    \
+    const size_t before = set->count;                                          \
+    for (size_t i = 0; i < count && set->count > 1; ++i)                       \
+      AocDsu##name##Union(set, a[i], b[i]);                                    \
+    return before - set->count;                                                \
+  }
+
+#endif
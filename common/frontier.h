@@ -0,0 +1,26 @@
+#ifndef COMMON_FRONTIER_H
+#define COMMON_FRONTIER_H
+
+// pop and reset for an aoc/deque.h ring, mostly used as a breadth first
+// search frontier. the deque has no pop of its own, so these read the ring
+// directly. indices wrap with a mask, which assumes the deque was created with
+// AOC_BASE2_CAPACITY
+#define AOC_DEFINE_FRONTIER(type, name)                                        \
+  static inline type AocDeque##name##PopFront(AocDeque##name *const d) {       \
+    const type item = d->items[d->head];                                       \
+    d->head = (d->head + 1) & (d->capacity - 1);                               \
+    d->length--;                                                               \
+    return item;                                                               \
+  }                                                                            \
+                                                                               \
+  static inline type AocDeque##name##PopBack(AocDeque##name *const d) {        \
+    d->length--;                                                               \
+    return d->items[(d->head + d->length) & (d->capacity - 1)];                \
+  }                                                                            \
+                                                                               \
+  static inline void AocDeque##name##Reset(AocDeque##name *const d) {          \
+    d->head = 0;                                                               \
+    d->length = 0;                                                             \
+  }
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef COMMON_HASH_H
+#define COMMON_HASH_H
+
+#include <stdint.h>
+
+// integer mixers for hashset keys. every input bit affects every output bit,
+// so skewed keys like packed coordinates still spread over the whole table
+
+// lowbias32, the default
+static inline uint32_t mix32(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+// triple32, one more round than lowbias32 for even lower bias
+static inline uint32_t mix32_triple(uint32_t x) {
+  x ^= x >> 17;
+  x *= 0xed5ad4bbu;
+  x ^= x >> 11;
+  x *= 0xac4c1b51u;
+  x ^= x >> 15;
+  x *= 0x31848babu;
+  x ^= x >> 14;
+  return x;
+}
+
+// splitmix64 finalizer for 64 bit keys. the low half is a good 32 bit hash
+static inline uint64_t mix64(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9u;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebu;
+  x ^= x >> 31;
+  return x;
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef COMMON_HASHSTATS_H
+#define COMMON_HASHSTATS_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+#define AOC_HASHSET_STATS_BUCKETS 16
+
+// probe statistics of an aoc/hashset.h table. the last histogram bucket
+// counts every probe length of AOC_HASHSET_STATS_BUCKETS or more
+typedef struct {
+  size_t capacity;
+  size_t count;
+  double loadFactor;
+  double meanProbe;
+  size_t maxProbe;
+  size_t maxCluster;
+  size_t histogram[AOC_HASHSET_STATS_BUCKETS + 1];
+} aoc_hashset_stats;
+
+static inline void AocHashsetStatsPrint(FILE *const file,
+                                        const char *const name,
+                                        const aoc_hashset_stats *const s) {
+  fprintf(file,
+          "%s: %zu/%zu entries, load %.3f, mean probe %.3f, max probe %zu, "
+          "max cluster %zu\n",
+          name, s->count, s->capacity, s->loadFactor, s->meanProbe,
+          s->maxProbe, s->maxCluster);
+  fprintf(file, "%s: probe lengths", name);
+  for (size_t i = 0; i <= AOC_HASHSET_STATS_BUCKETS; ++i)
+    fprintf(file, " %zu%s:%zu", i, i == AOC_HASHSET_STATS_BUCKETS ? "+" : "",
+            s->histogram[i]);
+  fprintf(file, "\n");
+}
+
+// generates AocHashset<name>Stats, which walks the slots of a set and rehashes
+// every entry to find how far it sits from its home slot. it assumes linear
+// probing over a power of two capacity, like aoc/hashset.h with
+// AOC_BASE2_CAPACITY
+#define AOC_DEFINE_HASHSET_STATS(type, name, hash, equals, empty)              \
+  static inline aoc_hashset_stats AocHashset##name##Stats(                     \
+      const AocHashset##name *const set) {                                     \
+    aoc_hashset_stats stats = {.capacity = set->capacity};                     \
+    const type emptyEntry = empty;                                             \
+    const size_t mask = set->capacity - 1;                                     \
+    size_t totalProbe = 0;                                                     \
+    size_t cluster = 0;                                                        \
+    size_t leadingCluster = 0;                                                 \
+    for (size_t i = 0; i < set->capacity; ++i) {                               \
+      const type *const entry = &set->entries[i];                              \
+      if (equals(entry, &emptyEntry)) {                                        \
+        if (leadingCluster == 0 && cluster == i)                               \
+          leadingCluster = cluster;                                            \
+        cluster = 0;                                                           \
+        continue;                                                              \
+      }                                                                        \
+      cluster++;                                                               \
+      if (cluster > stats.maxCluster)                                          \
+        stats.maxCluster = cluster;                                            \
+      const size_t probe = (i - (hash(entry) & mask)) & mask;                  \
+      totalProbe += probe;                                                     \
+      if (probe > stats.maxProbe)                                              \
+        stats.maxProbe = probe;                                                \
+      stats.histogram[probe < AOC_HASHSET_STATS_BUCKETS                        \
+                          ? probe                                              \
+                          : AOC_HASHSET_STATS_BUCKETS]++;                      \
+      stats.count++;                                                           \
+    }                                                                          \
+    /* a cluster can wrap around from the last slot to the first one */        \
+    if (cluster > 0 && cluster < set->capacity &&                              \
+        cluster + leadingCluster > stats.maxCluster)                           \
+      stats.maxCluster = cluster + leadingCluster;                             \
+    stats.loadFactor = (double)stats.count / (double)set->capacity;            \
+    stats.meanProbe =                                                          \
+        stats.count > 0 ? (double)totalProbe / (double)stats.count : 0.0;      \
+    return stats;                                                              \
+  }
+
+#endif
@@ -0,0 +1,229 @@
+#define _GNU_SOURCE
+#include <elf.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+// sampling profiler that `make profile=1` links into every day. a SIGPROF
+// timer records the call stack once per millisecond of cpu time. on exit the
+// stacks are symbolized from the binary's own symbol table and written as
+// folded stacks to <day>.folded, which flamegraph.pl turns into a flame graph
+
+#define PROFILE_INTERVAL_US 1000
+#define PROFILE_MAX_DEPTH 64
+#define PROFILE_MAX_SAMPLES (1 << 15)
+#define PROFILE_MAX_NAME 128
+
+// the signal handler and the signal trampoline are on top of every stack
+#define PROFILE_SKIP_FRAMES 2
+
+static void *stacks[PROFILE_MAX_SAMPLES][PROFILE_MAX_DEPTH];
+static int depths[PROFILE_MAX_SAMPLES];
+static volatile sig_atomic_t sampleCount;
+static volatile sig_atomic_t droppedCount;
+
+static void on_sigprof(int signal) {
+  (void)signal;
+  const int savedErrno = errno;
+  const int i = sampleCount;
+  if (i < PROFILE_MAX_SAMPLES) {
+    depths[i] = backtrace(stacks[i], PROFILE_MAX_DEPTH);
+    sampleCount = i + 1;
+  } else {
+    droppedCount++;
+  }
+  errno = savedErrno;
+}
+
+typedef struct {
+  uintptr_t start;
+  uintptr_t end;
+  const char *name;
+} symbol;
+
+typedef struct {
+  char *image;
+  symbol *symbols;
+  size_t count;
+  uintptr_t bias;
+} symbol_table;
+
+// provided by the linker at the first byte of the executable. comparing its
+// runtime address with its symbol value gives the load bias of a pie binary
+extern char __executable_start;
+
+static char *read_file(const char *const path) {
+  FILE *const file = fopen(path, "rb");
+  if (file == NULL)
+    return NULL;
+  fseek(file, 0, SEEK_END);
+  const long length = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  char *const contents = length > 0 ? malloc((size_t)length) : NULL;
+  if (contents != NULL &&
+      fread(contents, 1, (size_t)length, file) != (size_t)length) {
+    free(contents);
+    fclose(file);
+    return NULL;
+  }
+  fclose(file);
+  return contents;
+}
+
+static int compare_symbols(const void *const a, const void *const b) {
+  const uintptr_t left = ((const symbol *)a)->start;
+  const uintptr_t right = ((const symbol *)b)->start;
+  return (left > right) - (left < right);
+}
+
+static bool load_symbols(symbol_table *const table) {
+  char *const image = read_file("/proc/self/exe");
+  if (image == NULL)
+    return false;
+
+  const Elf64_Ehdr *const header = (const Elf64_Ehdr *)image;
+  if (memcmp(header->e_ident, ELFMAG, SELFMAG) != 0 ||
+      header->e_ident[EI_CLASS] != ELFCLASS64) {
+    free(image);
+    return false;
+  }
+
+  // the static symbol table also has the local functions every day is made
+  // of. the dynamic one would only have the exported ones
+  const Elf64_Shdr *const sections =
+      (const Elf64_Shdr *)(image + header->e_shoff);
+  uintptr_t linkedStart = 0;
+  size_t count = 0;
+  symbol *symbols = NULL;
+  for (size_t s = 0; s < header->e_shnum; ++s) {
+    if (sections[s].sh_type != SHT_SYMTAB)
+      continue;
+    const Elf64_Sym *const entries =
+        (const Elf64_Sym *)(image + sections[s].sh_offset);
+    const size_t entryCount = sections[s].sh_size / sizeof(Elf64_Sym);
+    const Elf64_Shdr *const strings = &sections[sections[s].sh_link];
+    const char *const names = image + strings->sh_offset;
+    symbols = realloc(symbols, sizeof(symbol) * (count + entryCount));
+    for (size_t i = 0; i < entryCount; ++i) {
+      const char *const name = names + entries[i].st_name;
+      if (strcmp(name, "__executable_start") == 0)
+        linkedStart = entries[i].st_value;
+      if (ELF64_ST_TYPE(entries[i].st_info) != STT_FUNC ||
+          entries[i].st_value == 0)
+        continue;
+      symbols[count++] = (symbol){
+          .start = entries[i].st_value,
+          .end = entries[i].st_value + entries[i].st_size,
+          .name = name,
+      };
+    }
+  }
+  qsort(symbols, count, sizeof(symbol), compare_symbols);
+
+  table->image = image;
+  table->symbols = symbols;
+  table->count = count;
+  table->bias = (uintptr_t)&__executable_start - linkedStart;
+  return true;
+}
+
+static const char *find_symbol(const symbol_table *const table,
+                               const uintptr_t address) {
+  const uintptr_t linked = address - table->bias;
+  size_t low = 0;
+  size_t high = table->count;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    if (table->symbols[mid].start <= linked)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  if (low == 0 || linked >= table->symbols[low - 1].end)
+    return "[unknown]";
+  return table->symbols[low - 1].name;
+}
+
+static int compare_lines(const void *const a, const void *const b) {
+  return strcmp(*(char *const *)a, *(char *const *)b);
+}
+
+static void write_folded_stacks(void) {
+  const struct itimerval stop = {{0, 0}, {0, 0}};
+  setitimer(ITIMER_PROF, &stop, NULL);
+
+  const int count = sampleCount;
+  symbol_table table = {0};
+  if (count == 0 || !load_symbols(&table))
+    return;
+
+  // one line per sample, outermost frame first
+  const size_t lineSize = PROFILE_MAX_DEPTH * (PROFILE_MAX_NAME + 1);
+  char *const buffer = malloc(lineSize * (size_t)count);
+  char **const lines = malloc(sizeof(char *) * (size_t)count);
+  for (int i = 0; i < count; ++i) {
+    char *line = buffer + lineSize * (size_t)i;
+    lines[i] = line;
+    line[0] = '\0';
+    size_t length = 0;
+    for (int f = depths[i] - 1; f >= PROFILE_SKIP_FRAMES; --f) {
+      // return addresses point after the call, step back into it. the
+      // innermost frame is the interrupted instruction itself
+      uintptr_t address = (uintptr_t)stacks[i][f];
+      if (f > PROFILE_SKIP_FRAMES)
+        address--;
+      length += (size_t)snprintf(line + length, lineSize - length, "%s%.*s",
+                                 length > 0 ? ";" : "", PROFILE_MAX_NAME,
+                                 find_symbol(&table, address));
+    }
+  }
+  qsort(lines, (size_t)count, sizeof(char *), compare_lines);
+
+  char path[256];
+  snprintf(path, sizeof(path), "%s.folded", program_invocation_short_name);
+  FILE *const file = fopen(path, "w");
+  if (file != NULL) {
+    for (int i = 0; i < count;) {
+      int end = i + 1;
+      while (end < count && strcmp(lines[i], lines[end]) == 0)
+        end++;
+      fprintf(file, "%s %d\n", lines[i], end - i);
+      i = end;
+    }
+    fclose(file);
+    fprintf(stderr, "profile: %d samples written to %s", count, path);
+    if (droppedCount > 0)
+      fprintf(stderr, ", %d dropped", (int)droppedCount);
+    fprintf(stderr, "\n");
+  }
+
+  free(lines);
+  free(buffer);
+  free(table.symbols);
+  free(table.image);
+}
+
+__attribute__((constructor)) static void start_profiler(void) {
+  // the first backtrace loads the unwinder, which must not happen inside the
+  // signal handler
+  void *frames[1];
+  backtrace(frames, 1);
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = on_sigprof;
+  action.sa_flags = SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGPROF, &action, NULL);
+
+  const struct itimerval interval = {{0, PROFILE_INTERVAL_US},
+                                     {0, PROFILE_INTERVAL_US}};
+  setitimer(ITIMER_PROF, &interval, NULL);
+  atexit(write_folded_stacks);
+}
@@ -0,0 +1,20 @@
+#ifndef COMMON_SORT_H
+#define COMMON_SORT_H
+
+#include <stddef.h>
+
+// insertion sort for arrays that change little between sorts. close to
+// linear when the items are nearly sorted already. `compare` gets pointers
+// to two items and works like a qsort comparator
+#define AOC_DEFINE_INSERTION_SORT(type, name, compare)                         \
+  static void AocInsertionSort##name(type *const items, const size_t count) {  \
+    for (size_t i = 1; i < count; ++i) {                                       \
+      type const item = items[i];                                              \
+      size_t j = i;                                                            \
+      for (; j > 0 && compare(&items[j - 1], &item) > 0; --j)                  \
+        items[j] = items[j - 1];                                               \
+      items[j] = item;                                                         \
+    }                                                                          \
+  }
+
+#endif
@@ -1,81 +1,333 @@
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <aoc/aoc.h>
 #include <aoc/mem.h>
-#include <aoc/bump.h>
+#include "../common/hash.h"
 
-#define AOC_T int32_t
-#define AOC_T_NAME I32
-#include <aoc/array.h>
+typedef struct {
+  bool found;
+  int64_t step;
+  int64_t frequency;
+} repeat;
 
-static inline void parse_line(char *line, size_t length, void *userData) {
-  (void)length;
-  AocArrayI32Push(userData, (int32_t)strtol(line, NULL, 10));
-}
+typedef struct {
+  int64_t residue;
+  int64_t frequency;
+  size_t index;
+} prefix;
 
-static int32_t solve_part1(const AocArrayI32 *const numbers) {
-  int32_t sum = 0;
-  for (size_t i = 0; i < numbers->length; ++i)
-    sum += numbers->items[i];
-  return sum;
+static int compare_prefixes(const void *const a, const void *const b) {
+  const prefix *const left = a;
+  const prefix *const right = b;
+  if (left->residue != right->residue)
+    return left->residue < right->residue ? -1 : 1;
+  return (left->frequency > right->frequency) -
+         (left->frequency < right->frequency);
 }
 
-static inline uint32_t i32_hash(const int32_t *const i) {
-  return 54812489 * ((uint32_t)(*i) ^ 95723417);
+#define AOC_T int64_t
+#define AOC_T_NAME I64
+#include <aoc/array.h>
+
+#define AOC_T prefix
+#define AOC_T_NAME Prefix
+#include <aoc/array.h>
+
+static inline uint32_t i64_hash(const int64_t *const v) {
+  return (uint32_t)mix64((uint64_t)*v);
 }
 
-static inline bool i32_equals(const int32_t *const a, const int32_t *const b) {
+static inline bool i64_equals(const int64_t *const a, const int64_t *const b) {
   return *a == *b;
 }
 
-#define AOC_T int32_t
-#define AOC_T_NAME I32
-#define AOC_T_EMPTY ((int32_t){0})
-#define AOC_T_HFUNC i32_hash
-#define AOC_T_EQUALS i32_equals
+// frequencies stay far away from INT64_MIN, every delta fits into 32 bits
+#define AOC_T int64_t
+#define AOC_T_NAME I64
+#define AOC_T_EMPTY INT64_MIN
+#define AOC_T_HFUNC i64_hash
+#define AOC_T_EQUALS i64_equals
 #define AOC_BASE2_CAPACITY
 #include <aoc/hashset.h>
 
-static int32_t solve_part2(const AocArrayI32 *const numbers) {
-  AocHashsetI32 frequencies = {0};
-  AocHashsetI32Create(&frequencies, 1 << 18);
+// an append only feed of deltas. appending a batch only does work for that
+// batch: the running sum, the frequency before every delta and the set of
+// those frequencies grow in place. a frequency reached twice within the feed
+// is found while appending. later deltas can not come before it, so from then
+// on only the sum is kept
+typedef struct {
+  int64_t sum;
+  AocArrayI64 frequencies;
+  AocHashsetI64 seen;
+  repeat streamRepeat;
+  // queries without a repeat in the feed sort the frequencies into this
+  // buffer. the answer is cached until the next append
+  AocArrayPrefix prefixes;
+  size_t queriedLength;
+  repeat queried;
+} delta_feed;
 
+static void delta_feed_create(delta_feed *const feed, const size_t capacity) {
+  *feed = (delta_feed){0};
+  AocArrayI64Create(&feed->frequencies, capacity);
+  AocHashsetI64Create(&feed->seen, 2 * capacity);
+  AocArrayPrefixCreate(&feed->prefixes, capacity);
+}
+
+static void delta_feed_destroy(delta_feed *const feed) {
+  AocArrayPrefixDestroy(&feed->prefixes);
+  AocHashsetI64Destroy(&feed->seen);
+  AocArrayI64Destroy(&feed->frequencies);
+}
+
+static void delta_feed_append(delta_feed *const feed,
+                              const int32_t *const deltas, const size_t count) {
   size_t i = 0;
-  int32_t frequency = 0;
-  for (;;) {
-    frequency += numbers->items[i];
+  for (; i < count && !feed->streamRepeat.found; ++i) {
     uint32_t hash = 0;
-    if (AocHashsetI32Contains(&frequencies, frequency, &hash)) {
-      AocHashsetI32Destroy(&frequencies);
-      return frequency;
-    } else {
-      AocHashsetI32InsertPreHashed(&frequencies, frequency, hash);
+    if (AocHashsetI64Contains(&feed->seen, feed->sum, &hash)) {
+      feed->streamRepeat = (repeat){
+          .found = true,
+          .step = (int64_t)feed->frequencies.length,
+          .frequency = feed->sum,
+      };
+      break;
+    }
+    AocHashsetI64InsertPreHashed(&feed->seen, feed->sum, hash);
+    AocArrayI64Push(&feed->frequencies, feed->sum);
+    feed->sum += deltas[i];
+  }
+  for (; i < count; ++i)
+    feed->sum += deltas[i];
+}
+
+static repeat find_repeat_across_passes(delta_feed *const feed) {
+  // every pass over the deltas shifts all frequencies of the first pass by
+  // the total drift. the frequency before delta i of pass k is
+  // frequencies[i] + k * drift, so two of them can only ever meet if they
+  // are congruent modulo the drift. the frequencies are all different, so
+  // within such a group only neighbours in sorted order have to be checked
+  const size_t n = feed->frequencies.length;
+  const int64_t drift = feed->sum;
+  // without drift the frequency is back at 0 after the first pass
+  if (drift == 0)
+    return (repeat){.found = true, .step = (int64_t)n, .frequency = 0};
+
+  const int64_t modulus = drift < 0 ? -drift : drift;
+  AocArrayPrefixClear(&feed->prefixes);
+  for (size_t i = 0; i < n; ++i) {
+    const int64_t f = feed->frequencies.items[i];
+    AocArrayPrefixPush(&feed->prefixes,
+                       (prefix){
+                           .residue = ((f % modulus) + modulus) % modulus,
+                           .frequency = f,
+                           .index = i,
+                       });
+  }
+  // the drift changes with every append, so does the order
+  prefix *const prefixes = feed->prefixes.items;
+  qsort(prefixes, n, sizeof(prefix), compare_prefixes);
+
+  repeat first = {0};
+  for (size_t i = 1; i < n; ++i) {
+    const prefix *const lower = &prefixes[i - 1];
+    const prefix *const higher = &prefixes[i];
+    if (lower->residue != higher->residue)
+      continue;
+    // the lower frequency climbs up to the higher one with positive drift and
+    // the higher one falls down to the lower one with negative drift
+    const int64_t passes = (higher->frequency - lower->frequency) / modulus;
+    const int64_t step =
+        passes * (int64_t)n +
+        (int64_t)(drift > 0 ? lower->index : higher->index);
+    if (!first.found || step < first.step)
+      first = (repeat){
+          .found = true,
+          .step = step,
+          .frequency = drift > 0 ? higher->frequency : lower->frequency,
+      };
+  }
+  return first;
+}
+
+static bool delta_feed_first_repeat(delta_feed *const feed,
+                                    int64_t *const result) {
+  if (feed->streamRepeat.found) {
+    *result = feed->streamRepeat.frequency;
+    return true;
+  }
+  const size_t n = feed->frequencies.length;
+  if (n == 0)
+    return false;
+  if (feed->queriedLength != n) {
+    feed->queried = find_repeat_across_passes(feed);
+    feed->queriedLength = n;
+  }
+  *result = feed->queried.frequency;
+  return feed->queried.found;
+}
+
+#define READ_CHUNK_SIZE (1 << 16)
+#define DELTA_BATCH_SIZE 1024
+
+typedef void (*delta_batch_func)(const int32_t *deltas, size_t count,
+                                 void *userData);
+
+typedef struct {
+  int32_t deltas[DELTA_BATCH_SIZE];
+  size_t count;
+  delta_batch_func onBatch;
+  void *userData;
+} delta_batch;
+
+static inline void delta_batch_push(delta_batch *const batch,
+                                    const int32_t delta) {
+  batch->deltas[batch->count++] = delta;
+  if (batch->count == DELTA_BATCH_SIZE) {
+    batch->onBatch(batch->deltas, batch->count, batch->userData);
+    batch->count = 0;
+  }
+}
+
+// a delta is an optional sign followed by digits. the parser sees the line
+// one character at a time, so a delta may span two chunks of the file
+typedef struct {
+  int64_t value;
+  int64_t sign;
+  bool hasSign;
+  bool hasDigits;
+  bool hasCarriageReturn;
+} delta_parser;
+
+static const char *parse_delta_char(delta_parser *const p, const char c) {
+  if (p->hasCarriageReturn)
+    return "carriage return inside a line";
+  const unsigned int digit = (unsigned int)(c - '0');
+  if (digit < 10) {
+    // INT32_MAX + 1 is still valid as INT32_MIN, anything above can not fit
+    p->value = p->value * 10 + digit;
+    if (p->value > (int64_t)INT32_MAX + 1)
+      return "delta does not fit into 32 bits";
+    p->hasDigits = true;
+    return NULL;
+  }
+  if ((c == '+' || c == '-') && !p->hasSign && !p->hasDigits) {
+    p->sign = c == '-' ? -1 : 1;
+    p->hasSign = true;
+    return NULL;
+  }
+  if (c == '\r') {
+    p->hasCarriageReturn = true;
+    return NULL;
+  }
+  return "expected a signed integer";
+}
+
+static const char *parse_delta_end(delta_parser *const p,
+                                   delta_batch *const batch) {
+  // blank lines are skipped
+  const delta_parser line = *p;
+  *p = (delta_parser){.sign = 1};
+  if (!line.hasDigits)
+    return line.hasSign ? "sign without digits" : NULL;
+  const int64_t delta = line.sign * line.value;
+  if (delta > INT32_MAX)
+    return "delta does not fit into 32 bits";
+  delta_batch_push(batch, (int32_t)delta);
+  return NULL;
+}
+
+static bool read_deltas(const char *const path, const delta_batch_func onBatch,
+                        void *const userData) {
+  // the file goes through a fixed buffer and the deltas are handed out in
+  // fixed size batches, so reading uses the same memory for any file size.
+  // malformed input stops the reading with an error on stderr
+  FILE *const file = fopen(path, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "%s: %s\n", path, strerror(errno));
+    return false;
+  }
+
+  static char chunk[READ_CHUNK_SIZE];
+  delta_batch batch = {.onBatch = onBatch, .userData = userData};
+  delta_parser parser = {.sign = 1};
+  const char *error = NULL;
+  size_t line = 1;
+  size_t read = 0;
+  while (error == NULL && (read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    for (size_t i = 0; i < read && error == NULL; ++i) {
+      const char c = chunk[i];
+      error = c == '\n' ? parse_delta_end(&parser, &batch)
+                        : parse_delta_char(&parser, c);
+      if (error == NULL && c == '\n')
+        line++;
     }
-    i = (i + 1) % numbers->length;
   }
+  if (error == NULL && ferror(file))
+    error = "read error";
+  fclose(file);
 
-  // should never reach
-  AocHashsetI32Destroy(&frequencies);
-  return -1;
+  // the last line might not end with a line break
+  if (error == NULL)
+    error = parse_delta_end(&parser, &batch);
+  if (error != NULL) {
+    fprintf(stderr, "%s:%zu: %s\n", path, line, error);
+    return false;
+  }
+  if (batch.count > 0)
+    onBatch(batch.deltas, batch.count, userData);
+  return true;
 }
 
-int main(void) {
-  aoc_bump bump = {0};
-  AocBumpInit(&bump, 1052592);
+static void sum_deltas(const int32_t *const deltas, const size_t count,
+                       void *const userData) {
+  int64_t sum = 0;
+  for (size_t i = 0; i < count; ++i)
+    sum += deltas[i];
+  *(int64_t *)userData += sum;
+}
 
-  aoc_allocator allocator = AocBumpCreateAllocator(&bump);
-  AocMemSetAllocator(&allocator);
+typedef struct {
+  delta_feed feed;
+  bool found;
+  int64_t firstRepeat;
+} live_feed;
 
-  AocArrayI32 numbers = {0};
-  AocArrayI32Create(&numbers, 1000);
-  AocReadFileLineByLine("day01/input.txt", parse_line, &numbers);
+static void append_deltas(const int32_t *const deltas, const size_t count,
+                          void *const userData) {
+  // the answers are kept up to date after every batch, like for a feed that
+  // never ends
+  live_feed *const live = userData;
+  delta_feed_append(&live->feed, deltas, count);
+  live->found = delta_feed_first_repeat(&live->feed, &live->firstRepeat);
+}
 
-  const int32_t part1 = solve_part1(&numbers);
-  const int32_t part2 = solve_part2(&numbers);
+int main(int argc, char **argv) {
+  // with --part1 the deltas are only summed, which takes the same memory for
+  // any input size
+  if (argc > 1 && strcmp(argv[1], "--part1") == 0) {
+    int64_t part1 = 0;
+    if (!read_deltas("day01/input.txt", sum_deltas, &part1))
+      return 1;
+    printf("%ld\n", part1);
+    return 0;
+  }
+
+  live_feed live = {0};
+  delta_feed_create(&live.feed, 1024);
+  if (!read_deltas("day01/input.txt", append_deltas, &live)) {
+    delta_feed_destroy(&live.feed);
+    return 1;
+  }
 
-  printf("%d\n", part1);
-  printf("%d\n", part2);
+  printf("%ld\n", live.feed.sum);
+  if (live.found)
+    printf("%ld\n", live.firstRepeat);
+  else
+    printf("no frequency is reached twice\n");
 
-  AocBumpDestroy(&bump);
+  delta_feed_destroy(&live.feed);
 }
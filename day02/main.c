@@ -3,6 +3,7 @@
 #include <string.h>
 
 #include <aoc/aoc.h>
+#include <aoc/mem.h>
 
 typedef struct {
   char data[32];
@@ -12,6 +13,37 @@ typedef struct {
 #define AOC_T_NAME BoxId
 #include <aoc/array.h>
 
+// an id with the character at mask left out. the hash is computed without
+// that character when the id is created
+typedef struct {
+  const char *data;
+  uint32_t hash;
+  uint8_t mask;
+} masked_id;
+
+static inline uint32_t masked_id_hash(const masked_id *const id) {
+  return id->hash;
+}
+
+static inline bool masked_id_equals(const masked_id *const a,
+                                    const masked_id *const b) {
+  if (a->data == NULL || b->data == NULL)
+    return a->data == b->data;
+  for (size_t i = 0; a->data[i] != '\0' || b->data[i] != '\0'; ++i) {
+    if (i != a->mask && a->data[i] != b->data[i])
+      return false;
+  }
+  return true;
+}
+
+#define AOC_T masked_id
+#define AOC_T_NAME MaskedId
+#define AOC_T_EMPTY ((masked_id){0})
+#define AOC_T_HFUNC masked_id_hash
+#define AOC_T_EQUALS masked_id_equals
+#define AOC_BASE2_CAPACITY
+#include <aoc/hashset.h>
+
 static void parse_line(char *line, size_t length, void *userData) {
   box_id id = {0};
   AocTrimRight(line, &length);
@@ -42,28 +74,89 @@ static int32_t solve_part1(const AocArrayBoxId *const ids) {
   return twos * threes;
 }
 
-static void solve_part2(const AocArrayBoxId *const ids, char output[const 32]) {
+#define HASH_BASE 0x100000001b3u
+#define NO_MASK UINT8_MAX
+
+static inline masked_id create_masked_id(const char *const data,
+                                         const uint64_t hash,
+                                         const uint8_t mask) {
+  return (masked_id){
+      .data = data,
+      .hash = (uint32_t)((hash * 0x9e3779b97f4a7c15u) >> 32),
+      .mask = mask,
+  };
+}
+
+static const char *find_masked_duplicate(const char *const *const ids,
+                                         const uint64_t *const hashes,
+                                         const size_t count,
+                                         const uint64_t power, const size_t k,
+                                         AocHashsetMaskedId *const seen) {
+  // the ids are unique, so two ids that are equal without position k differ
+  // exactly there
+  AocHashsetMaskedIdClear(seen);
+  for (size_t i = 0; i < count; ++i) {
+    const uint64_t masked = hashes[i] - (unsigned char)ids[i][k] * power;
+    const masked_id id = create_masked_id(ids[i], masked, (uint8_t)k);
+    uint32_t hash = 0;
+    if (AocHashsetMaskedIdContains(seen, id, &hash))
+      return ids[i];
+    AocHashsetMaskedIdInsertPreHashed(seen, id, hash);
+  }
+  return NULL;
+}
+
+static size_t solve_part2(const AocArrayBoxId *const ids,
+                          char output[const 32]) {
+  // two ids that differ only at position k are equal once k is left out. with
+  // a polynomial hash of every id the hash without k is one subtraction away,
+  // so every position costs a single pass over all ids instead of comparing
+  // all pairs. identical ids would also be equal without k, so they are
+  // removed first and their count is returned
   const size_t idLength = strlen(ids->items[0].data);
-  for (size_t i = 0; i < ids->length - 1; ++i) {
-    const box_id *const a = &ids->items[i];
-    for (size_t j = i + 1; j < ids->length; ++j) {
-      const box_id *const b = &ids->items[j];
-      int8_t differences = 0;
-      size_t lastDifference = 0;
-      for (size_t k = 0; k < idLength; ++k) {
-        if (a->data[k] != b->data[k]) {
-          differences++;
-          lastDifference = k;
-        }
-      }
-      if (differences == 1) {
-        AocMemCopy(output, a->data, lastDifference);
-        AocMemCopy(output + lastDifference, a->data + lastDifference + 1,
-                   idLength - lastDifference);
-        return;
-      }
+  uint64_t powers[32] = {0};
+  powers[idLength - 1] = 1;
+  for (size_t k = idLength - 1; k > 0; --k)
+    powers[k - 1] = powers[k] * HASH_BASE;
+
+  const char **const unique = AocAlloc(sizeof(const char *) * ids->length);
+  uint64_t *const hashes = AocAlloc(sizeof(uint64_t) * ids->length);
+  size_t count = 0;
+  size_t duplicates = 0;
+
+  AocHashsetMaskedId seen = {0};
+  AocHashsetMaskedIdCreate(&seen, 512);
+  for (size_t i = 0; i < ids->length; ++i) {
+    const char *const data = ids->items[i].data;
+    uint64_t hash = 0;
+    for (size_t j = 0; j < idLength; ++j)
+      hash = hash * HASH_BASE + (unsigned char)data[j];
+
+    const masked_id id = create_masked_id(data, hash, NO_MASK);
+    uint32_t setHash = 0;
+    if (AocHashsetMaskedIdContains(&seen, id, &setHash)) {
+      duplicates++;
+      continue;
+    }
+    AocHashsetMaskedIdInsertPreHashed(&seen, id, setHash);
+    unique[count] = data;
+    hashes[count] = hash;
+    count++;
+  }
+
+  for (size_t k = 0; k < idLength; ++k) {
+    const char *const data =
+        find_masked_duplicate(unique, hashes, count, powers[k], k, &seen);
+    if (data != NULL) {
+      AocMemCopy(output, data, k);
+      AocMemCopy(output + k, data + k + 1, idLength - k);
+      break;
     }
   }
+  AocHashsetMaskedIdDestroy(&seen);
+  AocFree(hashes);
+  AocFree(unique);
+  return duplicates;
 }
 
 int main(void) {
@@ -74,10 +167,12 @@ int main(void) {
 
   const int32_t part1 = solve_part1(&ids);
   char part2[32] = {0};
-  solve_part2(&ids, part2);
+  const size_t duplicates = solve_part2(&ids, part2);
 
   printf("%d\n", part1);
   printf("%s\n", part2);
+  if (duplicates > 0)
+    fprintf(stderr, "identical ids skipped: %zu\n", duplicates);
 
   AocArrayBoxIdDestroy(&ids);
 }
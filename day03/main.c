@@ -4,6 +4,7 @@
 #include <aoc/aoc.h>
 #include <aoc/mem.h>
 #include <aoc/arena.h>
+#include "../common/hash.h"
 
 typedef struct {
   uint32_t left;
@@ -23,7 +24,7 @@ typedef struct {
 } point;
 
 static inline uint32_t point_hash(const point *const p) {
-  return 54812489 * (p->x ^ 95723417) * (p->y ^ 69660419);
+  return mix32(p->x ^ mix32(p->y));
 }
 
 static inline bool point_equals(const point *const a, const point *const b) {
@@ -79,15 +80,30 @@ static bool get_intersection_area(const rectangle *const a,
   return true;
 }
 
+static int compare_rect_ptr_by_left(const void *const a, const void *const b) {
+  const rectangle *const left = *(rectangle *const *)a;
+  const rectangle *const right = *(rectangle *const *)b;
+  return (left->left > right->left) - (left->left < right->left);
+}
+
 static void solve_both(AocArrayRect *const claims, uint32_t *const part1,
                        uint32_t *const part2) {
   AocArrayRect intersections = {0};
   AocArrayRectCreate(&intersections, 1 << 11);
 
+  // sort by the left edge. only the following claims which start before the
+  // current one ends can intersect with it
+  rectangle **sorted = AocAlloc(sizeof(rectangle *) * claims->length);
+  for (size_t i = 0; i < claims->length; ++i)
+    sorted[i] = &claims->items[i];
+  qsort(sorted, claims->length, sizeof(rectangle *), compare_rect_ptr_by_left);
+
   for (size_t i = 0; i < claims->length - 1; ++i) {
-    rectangle *const a = &claims->items[i];
+    rectangle *const a = sorted[i];
     for (size_t j = i + 1; j < claims->length; ++j) {
-      rectangle *const b = &claims->items[j];
+      rectangle *const b = sorted[j];
+      if (b->left >= a->left + a->width)
+        break;
 
       rectangle intersection = {0};
       if (get_intersection_area(a, b, &intersection)) {
@@ -126,7 +142,7 @@ static void solve_both(AocArrayRect *const claims, uint32_t *const part1,
 
 int main(void) {
   aoc_arena arena = {0};
-  AocArenaAlloc(&arena, 2179096);
+  AocArenaAlloc(&arena, 2195480);
   AocArenaReset(&arena);
 
   aoc_allocator allocator = AocArenaCreateAllocator(&arena);
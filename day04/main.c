@@ -74,29 +74,13 @@ static inline int compare_records(const void *const a, const void *const b) {
                           &((const record *const)b)->time);
 }
 
-typedef struct {
-  uint8_t from;
-  uint8_t to;
-} range;
-
-#define AOC_T range
-#define AOC_T_NAME Range
-#include <aoc/array.h>
-
-typedef struct {
-  AocArrayRange sleepRanges;
-} shift;
-
-#define AOC_T shift
-#define AOC_T_NAME Shift
-#include <aoc/array.h>
-
 typedef struct {
   uint16_t guardId;
   uint32_t totalSleepTime;
   uint16_t biggestMinuteValue;
   uint8_t biggestMinute;
-  AocArrayShift shifts;
+  // how often the guard was asleep at each minute over all shifts
+  uint16_t minutes[60];
 } guard_schedule;
 
 typedef guard_schedule *schedule_ptr;
@@ -117,25 +101,9 @@ static inline bool try_find_schedule(const AocArraySchedule *const schedules,
   return false;
 }
 
-static void count_minutes(const AocArrayShift *const shifts,
-                          uint16_t minutes[const 60]) {
-  for (size_t i = 0; i < shifts->length; ++i) {
-    const shift *const s = &shifts->items[i];
-    for (uint8_t j = 0; j < s->sleepRanges.length; ++j) {
-      const range *const r = &s->sleepRanges.items[j];
-      for (uint8_t m = r->from; m < r->to; ++m) {
-        minutes[m]++;
-      }
-    }
-  }
-}
-
-static void get_biggest_minute(const AocArrayShift *const shifts,
+static void get_biggest_minute(const uint16_t minutes[const 60],
                                uint16_t *const biggestMinuteValue,
                                uint8_t *const biggestMinute) {
-  uint16_t minutes[60] = {0};
-  count_minutes(shifts, minutes);
-
   for (uint8_t i = 0; i < 60; ++i) {
     if (minutes[i] > *biggestMinuteValue) {
       *biggestMinuteValue = minutes[i];
@@ -153,13 +121,10 @@ static void parse_guard_schedules(const AocArrayRecord *const records,
     if (!try_find_schedule(schedules, guardId, &schedule)) {
       schedule = AocCalloc(1, sizeof(guard_schedule));
       schedule->guardId = guardId;
-      AocArrayShiftCreate(&schedule->shifts, 32);
       AocArraySchedulePush(schedules, schedule);
     }
     i++;
 
-    shift s = {0};
-    AocArrayRangeCreate(&s.sleepRanges, 4);
     uint16_t sleepStartTime = 0;
 
     const record *r = &records->items[i];
@@ -167,22 +132,19 @@ static void parse_guard_schedules(const AocArrayRecord *const records,
       if (r->type == RECORD_TYPE_FALLS_ASLEEP) {
         sleepStartTime = r->time.minute;
       } else /* wakes up */ {
-        range rn = {
-            .from = sleepStartTime,
-            .to = r->time.minute,
-        };
-        schedule->totalSleepTime += (rn.to - rn.from);
-        AocArrayRangePush(&s.sleepRanges, rn);
+        // count the minutes right away instead of storing the ranges
+        for (uint8_t m = sleepStartTime; m < r->time.minute; ++m)
+          schedule->minutes[m]++;
+        schedule->totalSleepTime += (r->time.minute - sleepStartTime);
       }
       i++;
       r = &records->items[i];
     }
-    AocArrayShiftPush(&schedule->shifts, s);
   }
 
   for (size_t i = 0; i < schedules->length; ++i) {
     guard_schedule *const schedule = schedules->items[i];
-    get_biggest_minute(&schedule->shifts, &schedule->biggestMinuteValue,
+    get_biggest_minute(schedule->minutes, &schedule->biggestMinuteValue,
                        &schedule->biggestMinute);
   }
 }
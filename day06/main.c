@@ -6,6 +6,7 @@
 #include <aoc/arena.h>
 #include <aoc/mem.h>
 #include <aoc/image.h>
+#include "../common/hash.h"
 
 typedef struct {
   int32_t x;
@@ -16,8 +17,16 @@ typedef struct {
 #define AOC_T_NAME Point
 #include <aoc/array.h>
 
+#define AOC_T point
+#define AOC_T_NAME Point
+#define AOC_BASE2_CAPACITY
+#include <aoc/deque.h>
+#include "../common/frontier.h"
+
+AOC_DEFINE_FRONTIER(point, Point)
+
 static inline uint32_t point_hash(const point *const p) {
-  return 54812489 * ((uint32_t)p->x ^ 95723417) * ((uint32_t)p->y ^ 69660419);
+  return mix32((uint32_t)p->x ^ mix32((uint32_t)p->y));
 }
 
 static inline bool point_equals(const point *const a, const point *const b) {
@@ -241,41 +250,31 @@ static void get_new_points(const point center, const point current,
 }
 
 static uint32_t calculate_area(const AocArrayPoint *const points,
-                               AocArrayPoint *const surroundingPoints,
+                               AocDequePoint *const surroundingPoints,
                                const point center) {
   uint32_t area = 1;
-  AocArrayPointClear(surroundingPoints);
-  AocArrayPointPush(surroundingPoints, center);
+  AocDequePointPushBack(surroundingPoints, center);
 
   point newPoints[4] = {0};
   uint8_t newPointCount = 0;
 
   while (surroundingPoints->length > 0) {
-    const size_t length = surroundingPoints->length;
-    for (size_t i = 0; i < length; ++i) {
-      const point p = surroundingPoints->items[i];
-      get_new_points(center, p, newPoints, &newPointCount);
-
-      for (size_t j = 0; j < newPointCount; ++j) {
-        uint32_t distance = manhattan_distance(center, newPoints[j]);
-        for (size_t k = 0; k < points->length; ++k) {
-          if (points->items[k].x == center.x && points->items[k].y == center.y)
-            continue;
-          uint32_t dist = manhattan_distance(points->items[k], newPoints[j]);
-          if (dist <= distance)
-            goto not_closest;
-        }
-        area++;
-        AocArrayPointPush(surroundingPoints, newPoints[j]);
-      not_closest:;
+    const point p = AocDequePointPopFront(surroundingPoints);
+    get_new_points(center, p, newPoints, &newPointCount);
+
+    for (size_t j = 0; j < newPointCount; ++j) {
+      uint32_t distance = manhattan_distance(center, newPoints[j]);
+      for (size_t k = 0; k < points->length; ++k) {
+        if (points->items[k].x == center.x && points->items[k].y == center.y)
+          continue;
+        uint32_t dist = manhattan_distance(points->items[k], newPoints[j]);
+        if (dist <= distance)
+          goto not_closest;
       }
+      area++;
+      AocDequePointPushBack(surroundingPoints, newPoints[j]);
+    not_closest:;
     }
-
-    const size_t newLength = surroundingPoints->length - length;
-    for (size_t j = 0; j < newLength; ++j)
-      surroundingPoints->items[j] = surroundingPoints->items[length + j];
-
-    surroundingPoints->length = newLength;
   }
 
   return area;
@@ -290,8 +289,8 @@ static uint32_t solve_part1(const AocArrayPoint *const points) {
   const rectangle bounds = find_bounds(points);
   AocArrayPoint finitePoints = get_finite_points(points, bounds);
 
-  AocArrayPoint surroundingPoints = {0};
-  AocArrayPointCreate(&surroundingPoints, 1 << 10);
+  AocDequePoint surroundingPoints = {0};
+  AocDequePointCreate(&surroundingPoints, 1 << 10);
   for (size_t i = 0; i < finitePoints.length; ++i) {
     const point p = finitePoints.items[i];
 
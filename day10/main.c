@@ -3,6 +3,7 @@
 #include <math.h>
 
 #include <aoc/aoc.h>
+#include "../common/hash.h"
 
 typedef struct {
   int x;
@@ -10,7 +11,7 @@ typedef struct {
 } point;
 
 static inline uint32_t point_hash(const point *const p) {
-  return 54812489 * ((uint32_t)p->x ^ 95723417) * ((uint32_t)p->y ^ 69660419);
+  return mix32((uint32_t)p->x ^ mix32((uint32_t)p->y));
 }
 
 static inline bool point_equals(const point *const a, const point *const b) {
@@ -137,25 +137,68 @@ static int64_t solve_part1(context *const ctx) {
   return calc_sum(&ctx->pots);
 }
 
+static bool find_full_range(const AocDequePot *const pots, int *const first,
+                            int *const last) {
+  *first = -1;
+  for (int i = 0; i < (int)pots->length; ++i) {
+    if (get_item_at(pots, i)->full) {
+      if (*first == -1)
+        *first = i;
+      *last = i;
+    }
+  }
+  return *first != -1;
+}
+
+static bool is_shifted(const AocDequePot *const before,
+                       const AocDequePot *const after, int64_t *const shift,
+                       int64_t *const fullCount) {
+  // checks whether `after` is the same pattern as `before` just at other ids
+  int firstBefore, lastBefore, firstAfter, lastAfter;
+  if (!find_full_range(after, &firstAfter, &lastAfter)) {
+    // a pattern that died out stays empty
+    *shift = 0;
+    *fullCount = 0;
+    return true;
+  }
+  if (!find_full_range(before, &firstBefore, &lastBefore) ||
+      lastBefore - firstBefore != lastAfter - firstAfter)
+    return false;
+
+  *fullCount = 0;
+  for (int i = 0; i <= lastBefore - firstBefore; ++i) {
+    const bool full = get_item_at(before, firstBefore + i)->full;
+    if (full != get_item_at(after, firstAfter + i)->full)
+      return false;
+    *fullCount += full;
+  }
+  *shift = get_item_at(after, firstAfter)->id -
+           get_item_at(before, firstBefore)->id;
+  return true;
+}
+
 static int64_t solve_part2(context *const ctx, const int64_t ticks) {
-  int64_t sumBefore = 0;
-  int64_t sum = 0;
-  int64_t sumDiffBefore = 0;
-  int64_t sumDiff = 0;
+  AocDequePot previous = {0};
+  AocDequePotDuplicate(&previous, &ctx->pots);
+  int64_t shift = 0;
+  int64_t fullCount = 0;
   int64_t i = 0;
 
   // start where part 1 left off at 20
   for (i = 20; i < ticks; ++i) {
+    AocDequePotEnsureCapacity(&previous, ctx->pots.capacity);
+    AocDequePotCopy(&previous, &ctx->pots);
     tick(ctx);
-    sumBefore = sum;
-    sum = calc_sum(&ctx->pots);
-    sumDiffBefore = sumDiff;
-    sumDiff = sum - sumBefore;
-    if (sumDiff == sumDiffBefore)
+    // once the pattern only moves, every full pot moves by the same amount on
+    // every following tick
+    if (is_shifted(&previous, &ctx->pots, &shift, &fullCount)) {
+      i++;
       break;
+    }
   }
 
-  return sum + ((ticks - i - 1) * sumDiff);
+  AocDequePotDestroy(&previous);
+  return calc_sum(&ctx->pots) + ((ticks - i) * fullCount * shift);
 }
 
 int main(void) {
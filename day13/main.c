@@ -2,6 +2,7 @@
 #include <stdlib.h>
 
 #include <aoc/aoc.h>
+#include "../common/sort.h"
 
 typedef enum {
   TILE_TYPE_EMPTY,
@@ -227,19 +228,21 @@ static inline bool carts_collide(const cart *const a, const cart *const b) {
          (a->x == b->prevX && a->y == b->prevY);
 }
 
-static int compare_carts(const void *const c1, const void *const c2) {
-  const cart *const cart1 = c1;
-  const cart *const cart2 = c2;
+static inline int compare_carts(const cart *const cart1,
+                                const cart *const cart2) {
   return ((cart1->y << 16) | cart1->x) - ((cart2->y << 16) | cart2->x);
 }
 
+// carts move at most one tile per tick so the order barely changes
+AOC_DEFINE_INSERTION_SORT(cart, Carts, compare_carts)
+
 static void solve_part1(context *const ctx, int16_t *const outX,
                         int16_t *const outY) {
   map *const m = &ctx->map;
   AocArrayCart *const carts = ctx->carts;
 
   for (;;) {
-    qsort(carts->items, carts->length, sizeof(cart), compare_carts);
+    AocInsertionSortCarts(carts->items, carts->length);
 
     for (size_t i = 0; i < carts->length; ++i)
       move_cart(&carts->items[i], m);
@@ -5,12 +5,18 @@
 #include <aoc/aoc.h>
 #include <aoc/mem.h>
 #include <aoc/bump.h>
+#include "../common/sort.h"
 
 aoc_bump mainBump = {0};
 aoc_bump pathFindingBump = {0};
 aoc_allocator mainAllocator = {0};
 aoc_allocator pathFindingAllocator = {0};
 
+// visited tiles of the path finding. a tile counts as visited if it holds the
+// current generation, so starting a new search doesn't need any clearing
+uint32_t *visited = NULL;
+uint32_t visitedGeneration = 0;
+
 typedef struct {
   uint8_t x;
   uint8_t y;
@@ -28,7 +34,10 @@ typedef struct {
   int8_t id;
 } unit;
 
+// unknown characters keep the zero entry of the lookup table. nothing ever
+// moves onto or attacks such a tile, so it acts like a wall
 typedef enum {
+  TILE_TYPE_UNKNOWN,
   TILE_TYPE_EMPTY,
   TILE_TYPE_WALL,
   TILE_TYPE_UNIT,
@@ -52,23 +61,18 @@ typedef struct {
 
 #define AOC_T point
 #define AOC_T_NAME Point
-#include <aoc/array.h>
-
-static inline uint32_t point_hash(const point *const p) {
-  return 54812489 * ((uint32_t)p->x ^ 95723417) * ((uint32_t)p->y ^ 69660419);
-}
+#define AOC_BASE2_CAPACITY
+#include <aoc/deque.h>
+#include "../common/frontier.h"
 
-static inline bool point_equals(const point *const a, const point *const b) {
-  return a->x == b->x && a->y == b->y;
-}
+AOC_DEFINE_FRONTIER(point, Point)
 
-#define AOC_T point
-#define AOC_T_NAME Point
-#define AOC_T_EMPTY ((point){0, 0})
-#define AOC_T_HFUNC point_hash
-#define AOC_T_EQUALS point_equals
-#define AOC_BASE2_CAPACITY
-#include <aoc/hashset.h>
+static const tile_type tileLookup[256] = {
+    ['.'] = TILE_TYPE_EMPTY,
+    ['#'] = TILE_TYPE_WALL,
+    ['G'] = TILE_TYPE_UNIT,
+    ['E'] = TILE_TYPE_UNIT,
+};
 
 void parse_line(char *line, size_t length, void *userData,
                 const size_t lineNumber) {
@@ -80,40 +84,18 @@ void parse_line(char *line, size_t length, void *userData,
   }
   const int8_t y = (int8_t)lineNumber;
   for (int8_t x = 0; x < ctx->map.size; ++x) {
-    tile t = {0};
-    switch (line[x]) {
-    case '.':
-      t.type = TILE_TYPE_EMPTY;
-      break;
-    case '#':
-      t.type = TILE_TYPE_WALL;
-      break;
-    case 'G':
-      t.type = TILE_TYPE_UNIT;
-      ctx->units[UNIT_TYPE_GOBLIN][ctx->counts[UNIT_TYPE_GOBLIN]] = (unit){
+    tile t = {.type = tileLookup[(unsigned char)line[x]]};
+    if (t.type == TILE_TYPE_UNIT) {
+      const unit_type type = line[x] == 'G' ? UNIT_TYPE_GOBLIN : UNIT_TYPE_ELF;
+      const uint8_t i = ctx->counts[type]++;
+      ctx->units[type][i] = (unit){
           .pos.x = x,
           .pos.y = y,
-          .id = ctx->counts[UNIT_TYPE_GOBLIN],
+          .id = i,
           .hp = 200,
-          .type = UNIT_TYPE_GOBLIN,
+          .type = type,
       };
-      t.u = &ctx->units[UNIT_TYPE_GOBLIN][ctx->counts[UNIT_TYPE_GOBLIN]];
-      ctx->counts[UNIT_TYPE_GOBLIN]++;
-      break;
-    case 'E':
-      t.type = TILE_TYPE_UNIT;
-      ctx->units[UNIT_TYPE_ELF][ctx->counts[UNIT_TYPE_ELF]] = (unit){
-          .pos.x = x,
-          .pos.y = y,
-          .id = ctx->counts[UNIT_TYPE_ELF],
-          .hp = 200,
-          .type = UNIT_TYPE_ELF,
-      };
-      t.u = &ctx->units[UNIT_TYPE_ELF][ctx->counts[UNIT_TYPE_ELF]];
-      ctx->counts[UNIT_TYPE_ELF]++;
-      break;
-    default:
-      continue;
+      t.u = &ctx->units[type][i];
     }
     ctx->map.data[y * ctx->map.size + x] = t;
   }
@@ -145,161 +127,110 @@ static inline int compare_point(const point *const a, const point *const b) {
   return (((int)a->y << 8) | a->x) - (((int)b->y << 8) | b->x);
 }
 
-static inline int compare_unit_ptr(const void *const left,
-                                   const void *const right) {
-  const unit *const *const a = left;
-  const unit *const *const b = right;
+static inline int compare_unit_ptrs(unit *const *const a,
+                                    unit *const *const b) {
   return compare_point(&(*a)->pos, &(*b)->pos);
 }
 
-static inline void sort_unit_ptrs(unit **const units, const uint8_t count) {
-  qsort(units, count, sizeof(unit *), compare_unit_ptr);
-}
+// units only move one tile per round so the previous order is almost sorted
+AOC_DEFINE_INSERTION_SORT(unit *, UnitPtrs, compare_unit_ptrs)
 
-void get_valid_adjacent_points(const map *const m, const point pos,
-                               const unit_type targetType,
-                               point positions[const 4],
-                               uint8_t *const positionCount) {
-  *positionCount = 0;
+static inline void get_adjacent_points(const point pos,
+                                       point adjacent[const 4]) {
   // reading order
-  const point adjacent[4] = {
-      {pos.x + 0, pos.y - 1}, // up
-      {pos.x - 1, pos.y + 0}, // left
-      {pos.x + 1, pos.y + 0}, // right
-      {pos.x + 0, pos.y + 1}, // down
-  };
+  adjacent[0] = (point){pos.x + 0, pos.y - 1}; // up
+  adjacent[1] = (point){pos.x - 1, pos.y + 0}; // left
+  adjacent[2] = (point){pos.x + 1, pos.y + 0}; // right
+  adjacent[3] = (point){pos.x + 0, pos.y + 1}; // down
+}
+
+static bool is_in_range(const map *const m, const point pos,
+                        const unit_type targetType) {
+  point adjacent[4] = {0};
+  get_adjacent_points(pos, adjacent);
   for (uint8_t i = 0; i < 4; ++i) {
-    int index = adjacent[i].y * m->size + adjacent[i].x;
-    if (m->data[index].type <= TILE_TYPE_EMPTY ||
-        (m->data[index].type == TILE_TYPE_UNIT &&
-         m->data[index].u->type == targetType))
-      positions[(*positionCount)++] = adjacent[i];
+    const tile *const t = &m->data[adjacent[i].y * m->size + adjacent[i].x];
+    if (t->type == TILE_TYPE_UNIT && t->u->type == targetType)
+      return true;
   }
+  return false;
 }
 
-typedef struct {
-  point position;
-  point startingPoint;
-  point lastPoint;
-} bfs_data;
-
-#define AOC_T bfs_data
-#define AOC_T_NAME BfsData
-#include <aoc/array.h>
-
-int32_t shortest_path_to_target(const map *const m, const point from,
-                                const point to, const unit_type targetType,
-                                point *const nextPosition,
-                                point *const nextTargetPosition) {
-  // todo: could probably do something a lot faster with A*
-  AocBumpReset(&pathFindingBump);
-  AocMemSetAllocator(&pathFindingAllocator);
-
-  AocArrayBfsData data = {0};
-  AocArrayBfsDataCreate(&data, 1 << 12);
-
-  AocHashsetPoint visited = {0};
-  AocHashsetPointCreate(&visited, 1 << 12);
-  AocHashsetPointInsert(&visited, from);
-
-  point fromAdjacent[4] = {0};
-  uint8_t fromAdjacentCount = 0;
-  get_valid_adjacent_points(m, from, targetType, fromAdjacent,
-                            &fromAdjacentCount);
-
-  point toAdjacent[4] = {0};
-  uint8_t toAdjacentCount = 0;
-  get_valid_adjacent_points(m, to, targetType, toAdjacent, &toAdjacentCount);
-
-  int32_t shortestPathLength = INT32_MAX;
-  point bestStart = {0};
-  point bestEnd = {0};
-  bool foundPath = false;
-
-  for (uint8_t fi = 0; fi < fromAdjacentCount; ++fi) {
-    for (uint8_t ti = 0; ti < toAdjacentCount; ++ti) {
-      AocArrayBfsDataClear(&data);
-      AocHashsetPointClear(&visited);
-      bfs_data d = {
-          .lastPoint = from,
-          .startingPoint = fromAdjacent[fi],
-          .position = fromAdjacent[fi],
-      };
-      AocArrayBfsDataPush(&data, d);
-
-      int32_t pathLength = 0;
-      point start = {0};
-      point end = {0};
-      point toAdj = toAdjacent[ti];
-
-      while (data.length > 0) {
-        const size_t length = data.length;
-        for (size_t i = 0; i < length; ++i) {
-          const bfs_data *const current = &data.items[i];
-
-          if (current->position.x == toAdj.x &&
-              current->position.y == toAdj.y) {
-            start = current->startingPoint;
-            end = current->lastPoint;
-            foundPath = true;
-            goto done;
-          }
-
-          point adjacent[4] = {0};
-          uint8_t adjacentCount = 0;
-
-          get_valid_adjacent_points(m, current->position, targetType, adjacent,
-                                    &adjacentCount);
-          for (uint8_t j = 0; j < adjacentCount; ++j) {
-            uint32_t hash = 0;
-            if (!AocHashsetPointContains(&visited, adjacent[j], &hash)) {
-              AocHashsetPointInsertPreHashed(&visited, adjacent[j], hash);
-              const bfs_data d = {
-                  .lastPoint = current->position,
-                  .startingPoint = current->startingPoint,
-                  .position = adjacent[j],
-              };
-              AocArrayBfsDataPush(&data, d);
-            }
-          }
-        }
-
-        const size_t newLength = data.length - length;
-        for (size_t j = 0; j < newLength; ++j)
-          data.items[j] = data.items[length + j];
-        data.length = newLength;
-        pathLength++;
+typedef bool (*search_goal_func)(const map *const m, const point pos,
+                                 const void *const userData);
+
+static bool search_closest(const map *const m, AocDequePoint *const queue,
+                           const point from, const search_goal_func isGoal,
+                           const void *const userData, point *const result) {
+  // breadth first search over empty tiles. the whole level of the first goal
+  // is searched so ties can be broken in reading order
+  bool found = false;
+  AocDequePointReset(queue);
+  visitedGeneration++;
+  visited[from.y * m->size + from.x] = visitedGeneration;
+  AocDequePointPushBack(queue, from);
+
+  while (queue->length > 0 && !found) {
+    const size_t length = queue->length;
+    for (size_t i = 0; i < length; ++i) {
+      const point current = AocDequePointPopFront(queue);
+      if (isGoal(m, current, userData) &&
+          (!found || compare_point(&current, result) < 0)) {
+        *result = current;
+        found = true;
       }
-      pathLength = -1;
-
-    done:
-      if (pathLength != -1 && pathLength < shortestPathLength) {
-        bestStart = start;
-        bestEnd = end;
-        shortestPathLength = pathLength;
-      } else if (pathLength == shortestPathLength) {
-        const int startComparison = compare_point(&bestStart, &start);
-        const int endComparison = compare_point(&bestEnd, &end);
-        if (endComparison > 0 || (endComparison == 0 && startComparison > 0)) {
-          bestStart = start;
-          bestEnd = end;
+
+      point adjacent[4] = {0};
+      get_adjacent_points(current, adjacent);
+      for (uint8_t j = 0; j < 4; ++j) {
+        const uint32_t index = adjacent[j].y * m->size + adjacent[j].x;
+        if (m->data[index].type == TILE_TYPE_EMPTY &&
+            visited[index] != visitedGeneration) {
+          visited[index] = visitedGeneration;
+          AocDequePointPushBack(queue, adjacent[j]);
         }
       }
     }
   }
+  return found;
+}
 
-  if (!foundPath) {
-    shortestPathLength = -1;
-  } else {
-    *nextPosition = bestStart;
-    *nextTargetPosition = bestEnd;
-  }
+static bool is_target_tile(const map *const m, const point pos,
+                           const void *const userData) {
+  const unit *const u = userData;
+  const unit_type targetType = (unit_type)(((int)u->type + 1) & 1);
+  return (pos.x != u->pos.x || pos.y != u->pos.y) &&
+         is_in_range(m, pos, targetType);
+}
 
-  AocHashsetPointDestroy(&visited);
-  AocArrayBfsDataDestroy(&data);
+static bool is_first_step(const map *const m, const point pos,
+                          const void *const userData) {
+  (void)m;
+  const unit *const u = userData;
+  // directly next to the unit
+  const int dx = (int)pos.x - (int)u->pos.x;
+  const int dy = (int)pos.y - (int)u->pos.y;
+  return dx * dx + dy * dy == 1;
+}
+
+static bool find_next_position(const map *const m, const unit *const u,
+                               point *const nextPosition) {
+  AocBumpReset(&pathFindingBump);
+  AocMemSetAllocator(&pathFindingAllocator);
+
+  AocDequePoint queue = {0};
+  AocDequePointCreate(&queue, 1 << 10);
 
+  // first find the closest tile next to any target. then search back from
+  // there to find the first step on one of the shortest paths to it
+  point target = {0};
+  const bool found =
+      search_closest(m, &queue, u->pos, is_target_tile, u, &target) &&
+      search_closest(m, &queue, target, is_first_step, u, nextPosition);
+
+  AocDequePointDestroy(&queue);
   AocMemSetAllocator(&mainAllocator);
-  return shortestPathLength;
+  return found;
 }
 
 bool get_adjacent_target(const map *const m, const unit *const u,
@@ -349,7 +280,7 @@ static void solve_part1(context *const ctx, const uint32_t elfAp,
 
   uint32_t rounds = 0;
   for (rounds = 0;; ++rounds) {
-    sort_unit_ptrs(allUnits, allUnitsCount);
+    AocInsertionSortUnitPtrs(allUnits, allUnitsCount);
 
     for (uint8_t i = 0; i < allUnitsCount; ++i) {
       unit *const u = allUnits[i];
@@ -361,41 +292,13 @@ static void solve_part1(context *const ctx, const uint32_t elfAp,
       if (remainingCounts[targetType] == 0)
         goto done;
 
-      unit *const targets = ctx->units[targetType];
-      const uint8_t count = ctx->counts[targetType];
-
       unit *target = NULL;
       if (get_adjacent_target(&ctx->map, u, &target)) {
         goto attack;
       }
 
       point nextPosition = u->pos;
-      point nextTargetPosition = {ctx->map.size, ctx->map.size};
-      int32_t shortestPath = INT32_MAX;
-      bool pathFound = false;
-
-      for (uint8_t j = 0; j < count; ++j) {
-        if (targets[j].hp <= 0)
-          continue;
-
-        point pos = {0};
-        point targetPos = {0};
-        const int32_t pathLength = shortest_path_to_target(
-            &ctx->map, u->pos, targets[j].pos, targetType, &pos, &targetPos);
-        if (pathLength != -1) {
-          if (pathLength < shortestPath ||
-              (pathLength == shortestPath &&
-               compare_point(&nextTargetPosition, &targetPos) > 0) ||
-              (pathLength == shortestPath &&
-               compare_point(&nextTargetPosition, &targetPos) == 0 &&
-               compare_point(&nextPosition, &pos) > 0)) {
-            nextPosition = pos;
-            nextTargetPosition = targetPos;
-            shortestPath = pathLength;
-            pathFound = true;
-          }
-        }
-      }
+      const bool pathFound = find_next_position(&ctx->map, u, &nextPosition);
 
       if (pathFound) {
         // move
@@ -459,6 +362,8 @@ int main(void) {
   AocReadFileLineByLineEx("day15/input.txt", parse_line, &ctx);
   context clone = {0};
   clone_context(&clone, &ctx);
+  visited = AocCalloc((size_t)ctx.map.size * (size_t)ctx.map.size,
+                      sizeof(uint32_t));
 
   uint32_t part1 = 0;
   solve_part1(&clone, 3, &part1, NULL);
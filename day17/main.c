@@ -13,7 +13,11 @@ typedef struct {
 
 #define AOC_T point
 #define AOC_T_NAME Point
-#include <aoc/array.h>
+#define AOC_BASE2_CAPACITY
+#include <aoc/deque.h>
+#include "../common/frontier.h"
+
+AOC_DEFINE_FRONTIER(point, Point)
 
 typedef struct {
   u16 fromX;
@@ -102,7 +106,7 @@ static inline bool can_be_settled_on(const tile_type t) {
 }
 
 static void fill_reservoir(map *const m, const point p,
-                           AocArrayPoint *const newFalling) {
+                           AocDequePoint *const newFalling) {
   // # # |      # # |      # # |      # #^^^^^|
   // # # |  #   # # |  #   # #~~~~#   # #~~~~#
   // #   |  #   #~~~~~~#   #~~~~~~#   #~~~~~~#
@@ -165,11 +169,12 @@ static void fill_reservoir(map *const m, const point p,
 
     if (!leftCanBeSettledOn) {
       t[from] = TILE_TYPE_FALLING_WATER;
-      AocArrayPointPush(newFalling, (point){from % m->width, from / m->width});
+      AocDequePointPushBack(newFalling,
+                            (point){from % m->width, from / m->width});
     }
     if (!rightCanBeSettledOn) {
       t[to] = TILE_TYPE_FALLING_WATER;
-      AocArrayPointPush(newFalling, (point){to % m->width, to / m->width});
+      AocDequePointPushBack(newFalling, (point){to % m->width, to / m->width});
     }
 
     baseIndex -= m->width;
@@ -178,38 +183,30 @@ static void fill_reservoir(map *const m, const point p,
 
 static void solve(map *const m, const u32 yOffset, u32 *const part1,
                   u32 *const part2) {
-  AocArrayPoint current = {0};
-  AocArrayPointCreate(&current, 16);
-  AocArrayPointPush(&current, (point){500 - m->offsetX + 2, 0});
+  AocDequePoint current = {0};
+  AocDequePointCreate(&current, 16);
+  AocDequePointPushBack(&current, (point){500 - m->offsetX + 2, 0});
 
   while (current.length > 0) {
-    const size_t length = current.length;
-    for (size_t i = 0; i < length; ++i) {
-      point p = current.items[i];
-      if (p.y < m->height - 1) {
-        point newPos = {p.x, p.y + 1};
-        u32 index = newPos.y * m->width + newPos.x;
-
-        switch (m->tiles[index]) {
-        case TILE_TYPE_EMPTY:
-          m->tiles[index] = TILE_TYPE_FALLING_WATER;
-          AocArrayPointPush(&current, newPos);
-          break;
-        case TILE_TYPE_SOLID:
-        case TILE_TYPE_SETTLED_WATER:
-          fill_reservoir(m, p, &current);
-          break;
-        default:
-          // ignore
-          break;
-        }
+    const point p = AocDequePointPopFront(&current);
+    if (p.y < m->height - 1) {
+      point newPos = {p.x, p.y + 1};
+      u32 index = newPos.y * m->width + newPos.x;
+
+      switch (m->tiles[index]) {
+      case TILE_TYPE_EMPTY:
+        m->tiles[index] = TILE_TYPE_FALLING_WATER;
+        AocDequePointPushBack(&current, newPos);
+        break;
+      case TILE_TYPE_SOLID:
+      case TILE_TYPE_SETTLED_WATER:
+        fill_reservoir(m, p, &current);
+        break;
+      default:
+        // ignore
+        break;
       }
     }
-
-    const size_t newLength = current.length - length;
-    for (size_t j = 0; j < newLength; ++j)
-      current.items[j] = current.items[length + j];
-    current.length = newLength;
   }
 
   // skip all rows until the first clay block
@@ -219,7 +216,7 @@ static void solve(map *const m, const u32 yOffset, u32 *const part1,
     *part2 += m->tiles[i] == TILE_TYPE_SETTLED_WATER;
   }
 
-  AocArrayPointDestroy(&current);
+  AocDequePointDestroy(&current);
 }
 
 int main(void) {
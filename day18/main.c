@@ -1,33 +1,44 @@
 #include <aoc/aoc.h>
 #include <aoc/mem.h>
+#include "../common/cycle.h"
 #include <stdio.h>
 #include <string.h>
 
 #define MAP_SIZE 50
 #define MAP_TOTAL_SIZE (MAP_SIZE * MAP_SIZE)
 
+// unknown characters keep the zero entry of the lookup table and are skipped
 typedef enum {
+  TILE_TYPE_UNKNOWN,
   TILE_TYPE_OPEN,
   TILE_TYPE_TREES,
   TILE_TYPE_LUMBERYARD,
+  TILE_TYPE_COUNT,
 } tile_type;
 
 typedef tile_type map[MAP_SIZE * MAP_SIZE];
 
-static void parse(const char *str, map m) {
+static const tile_type tileLookup[256] = {
+    ['.'] = TILE_TYPE_OPEN,
+    ['#'] = TILE_TYPE_LUMBERYARD,
+    ['|'] = TILE_TYPE_TREES,
+};
+
+static int parse(const char *str, const size_t length, map m) {
+  // every character is translated with a table, line breaks and anything
+  // else unknown are skipped. stops at the end of the buffer or once the map
+  // is full and returns the number of tiles read
   int i = 0;
-  do {
-    // clang-format off
-    switch (*str) {
-    case '.': m[i++] = TILE_TYPE_OPEN; break;
-    case '#': m[i++] = TILE_TYPE_LUMBERYARD; break;
-    case '|': m[i++] = TILE_TYPE_TREES; break;
-    }
-    // clang-format on
-  } while (*(++str));
+  for (size_t j = 0; j < length && i < MAP_TOTAL_SIZE; ++j) {
+    const tile_type t = tileLookup[(unsigned char)str[j]];
+    if (t != TILE_TYPE_UNKNOWN)
+      m[i++] = t;
+  }
+  return i;
 }
 
-static tile_type transform(const tile_type current, const int counts[const 3]) {
+static tile_type transform(const tile_type current,
+                           const int counts[const TILE_TYPE_COUNT]) {
   switch (current) {
   case TILE_TYPE_OPEN:
     return counts[TILE_TYPE_TREES] >= 3 ? TILE_TYPE_TREES : TILE_TYPE_OPEN;
@@ -39,6 +50,8 @@ static tile_type transform(const tile_type current, const int counts[const 3]) {
                ? TILE_TYPE_LUMBERYARD
                : TILE_TYPE_OPEN;
     break;
+  default:
+    break;
   }
   // should never reach
   return TILE_TYPE_OPEN;
@@ -47,10 +60,10 @@ static tile_type transform(const tile_type current, const int counts[const 3]) {
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
 
-static void count_adjacent(map m, int x, int y, int counts[const 3]) {
-  counts[0] = 0;
-  counts[1] = 0;
-  counts[2] = 0;
+static void count_adjacent(map m, int x, int y,
+                           int counts[const TILE_TYPE_COUNT]) {
+  for (int t = 0; t < TILE_TYPE_COUNT; ++t)
+    counts[t] = 0;
   for (int ya = MAX(y - 1, 0); ya < MIN(y + 2, MAP_SIZE); ++ya) {
     for (int xa = MAX(x - 1, 0); xa < MIN(x + 2, MAP_SIZE); ++xa) {
       counts[m[ya * MAP_SIZE + xa]]++;
@@ -62,7 +75,7 @@ static void count_adjacent(map m, int x, int y, int counts[const 3]) {
 static void tick(map front, map back) {
   for (int y = 0; y < MAP_SIZE; ++y) {
     for (int x = 0; x < MAP_SIZE; ++x) {
-      int c[3] = {0};
+      int c[TILE_TYPE_COUNT] = {0};
       count_adjacent(front, x, y, c);
       int i = y * MAP_SIZE + x;
       back[i] = transform(front[i], c);
@@ -71,58 +84,52 @@ static void tick(map front, map back) {
 }
 
 static int count_total_resources(const map m) {
-  int counts[3] = {0};
+  int counts[TILE_TYPE_COUNT] = {0};
   for (int i = 0; i < MAP_TOTAL_SIZE; ++i)
     counts[m[i]]++;
   return counts[TILE_TYPE_LUMBERYARD] * counts[TILE_TYPE_TREES];
 }
 
-static void solve(map m, int *const part1, int *const part2) {
-  map buffer = {0};
-  // use double buffering
-  tile_type *front = m;
-  tile_type *back = buffer;
-
-#define DO_TICK()                                                              \
-  do {                                                                         \
-    tick(front, back);                                                         \
-    tile_type *tmp = front;                                                    \
-    front = back;                                                              \
-    back = tmp;                                                                \
-  } while (0)
-
-  int i = 0;
-  for (i = 0; i < 10; ++i)
-    DO_TICK();
-
-  *part1 = count_total_resources(front);
-
-  // arbitrary number
-  const int extraRuns = 500;
-
-  for (; i < extraRuns; ++i)
-    DO_TICK();
-
-  // take snapshot of current state
-  map snapshot;
-  memcpy(snapshot, m, sizeof(map));
+// the map is double buffered. a step writes the next generation into the
+// other buffer and flips over to it
+typedef struct {
+  map buffers[2];
+  int current;
+} forest;
+
+static void step(void *const state) {
+  forest *const f = state;
+  tick(f->buffers[f->current], f->buffers[f->current ^ 1]);
+  f->current ^= 1;
+}
 
-  // repeat transforming until the snapshot state is reached again
-  for (;; ++i) {
-    DO_TICK();
-    if (memcmp(snapshot, front, sizeof(map)) == 0)
-      break;
-  }
+static bool forest_equals(const void *const a, const void *const b) {
+  const forest *const left = a;
+  const forest *const right = b;
+  return memcmp(left->buffers[left->current], right->buffers[right->current],
+                sizeof(map)) == 0;
+}
 
-  // calculate difference
-  const int repeat = i - (extraRuns - 1);
-  // calclate missing runs
-  const int offset = (1000000000 - extraRuns) % repeat;
-  // do missing runs
-  for (int j = 0; j < offset; ++j)
-    DO_TICK();
+static int forest_resources(const forest *const f) {
+  return count_total_resources(f->buffers[f->current]);
+}
 
-  *part2 = count_total_resources(front);
+static void solve(const map m, int *const part1, int *const part2) {
+  forest initial = {.current = 0};
+  memcpy(initial.buffers[0], m, sizeof(map));
+
+  forest f = initial;
+  for (int i = 0; i < 10; ++i)
+    step(&f);
+  *part1 = forest_resources(&f);
+
+  // jump over all full cycles and do the missing steps
+  const aoc_cycle cycle =
+      AocFindCycle(&initial, &f, sizeof(forest), step, forest_equals);
+  const size_t offset = (1000000000 - cycle.start) % cycle.length;
+  for (size_t i = 0; i < offset; ++i)
+    step(&f);
+  *part2 = forest_resources(&f);
 }
 
 int main(void) {
@@ -130,7 +137,12 @@ int main(void) {
   char *contents = NULL;
   size_t length = 0;
   AocReadFileToString("day18/input.txt", &contents, &length);
-  parse(contents, m);
+  if (parse(contents, length, m) != MAP_TOTAL_SIZE) {
+    fprintf(stderr, "day18/input.txt is not a %dx%d map\n", MAP_SIZE,
+            MAP_SIZE);
+    AocFree(contents);
+    return 1;
+  }
 
   int part1 = 0;
   int part2 = 0;
@@ -2,6 +2,8 @@
 #include <aoc/mem.h>
 #include <stdio.h>
 #include <limits.h>
+#include "../common/hash.h"
+#include "../common/hashstats.h"
 
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
@@ -15,9 +17,16 @@ typedef struct {
 #define AOC_T_NAME Point
 #include <aoc/array.h>
 
+#define AOC_T point
+#define AOC_T_NAME Point
+#define AOC_BASE2_CAPACITY
+#include <aoc/deque.h>
+#include "../common/frontier.h"
+
+AOC_DEFINE_FRONTIER(point, Point)
+
 static inline uint32_t point_hash(const point *const p) {
-  return 47254019u ^ (((*(uint32_t *)&p->x) * 84560501u) ^
-                      ((*(uint32_t *)&p->y) * 57798941u));
+  return mix32((uint32_t)p->x ^ mix32((uint32_t)p->y));
 }
 
 static inline bool point_equals(const point *const a, const point *const b) {
@@ -34,6 +43,8 @@ static const point emptyPoint = {INT32_MIN, INT32_MIN};
 #define AOC_BASE2_CAPACITY
 #include <aoc/hashset.h>
 
+AOC_DEFINE_HASHSET_STATS(point, Point, point_hash, point_equals, emptyPoint)
+
 typedef struct {
   const AocHashsetPoint *hs;
   size_t current;
@@ -172,6 +183,12 @@ static map *parse(const char *expression) {
   }
 
 done:;
+#ifdef AOC_HASHSET_STATS
+  const aoc_hashset_stats spaceStats = AocHashsetPointStats(&spaces);
+  const aoc_hashset_stats doorStats = AocHashsetPointStats(&doors);
+  AocHashsetStatsPrint(stderr, "spaces", &spaceStats);
+  AocHashsetStatsPrint(stderr, "doors", &doorStats);
+#endif
   map *m = create_map(&spaces, &doors, minX, maxX, minY, maxY);
   AocArrayPointDestroy(&stack);
   AocHashsetPointDestroy(&doors);
@@ -197,41 +214,38 @@ static void get_adjacent_points(const map *const m, const point p,
 
 static void solve(const map *const m, uint32_t *const part1,
                   uint32_t *const part2) {
-  AocHashsetPoint visited = {0};
-  AocHashsetPointCreate(&visited, 1 << 6);
-  AocArrayPoint current = {0};
-  AocArrayPointCreate(&current, 1 << 14);
+  // the map is bounded so visited rooms can be tracked per tile
+  bool *visited = AocCalloc((size_t)m->width * (size_t)m->height, sizeof(bool));
+  AocDequePoint current = {0};
+  AocDequePointCreate(&current, 1 << 14);
 
-  AocHashsetPointInsert(&visited, m->start);
-  AocArrayPointPush(&current, m->start);
+  visited[m->start.y * m->width + m->start.x] = true;
+  AocDequePointPushBack(&current, m->start);
 
   uint32_t pathLength = 0;
   point adjacent[4] = {0};
   uint8_t adjacentCount = 0;
-  uint32_t hash = 0;
 
   while (current.length > 0) {
+    // only process the current level so the path length stays in sync
     const size_t length = current.length;
     for (size_t i = 0; i < length; ++i) {
-      point p = current.items[i];
+      const point p = AocDequePointPopFront(&current);
       get_adjacent_points(m, p, adjacent, &adjacentCount);
       for (uint8_t i = 0; i < adjacentCount; ++i) {
-        if (!AocHashsetPointContains(&visited, adjacent[i], &hash)) {
-          AocHashsetPointInsertPreHashed(&visited, adjacent[i], hash);
-          AocArrayPointPush(&current, adjacent[i]);
+        const int index = adjacent[i].y * m->width + adjacent[i].x;
+        if (!visited[index]) {
+          visited[index] = true;
+          AocDequePointPushBack(&current, adjacent[i]);
         }
       }
     }
-    const size_t newLength = current.length - length;
-    for (size_t j = 0; j < newLength; ++j)
-      current.items[j] = current.items[length + j];
-    current.length = newLength;
     pathLength++;
     if (pathLength >= 1000)
-      *part2 += newLength;
+      *part2 += current.length;
   }
-  AocArrayPointDestroy(&current);
-  AocHashsetPointDestroy(&visited);
+  AocDequePointDestroy(&current);
+  AocFree(visited);
   *part1 = pathLength - 1;
 }
 
@@ -2,8 +2,9 @@
 #include <stdint.h>
 
 int main(void) {
-  uint32_t arr[1 << 14] = {0};
-  uint32_t a = 0, b = 0, c = 0, length = 0;
+  // `a` is masked to 24 bits so all previous values fit into a bit set
+  static uint8_t seen[(1 << 24) / 8] = {0};
+  uint32_t a = 0, b = 0, c = 0, first = 0, last = 0, length = 0;
   for (;;) {
     b = a | 0x10000;
     a = 6780005;
@@ -16,11 +17,12 @@ int main(void) {
         break;
       }
     }
-    for (uint32_t i = 0; i < length; ++i)
-      if (arr[i] == a)
-        goto done;
-    arr[length++] = a;
+    if (seen[a >> 3] & (1 << (a & 7)))
+      break;
+    seen[a >> 3] |= 1 << (a & 7);
+    if (length++ == 0)
+      first = a;
+    last = a;
   }
-done:
-  printf("%u\n%u\n", arr[0], arr[length - 1]);
+  printf("%u\n%u\n", first, last);
 }
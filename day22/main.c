@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
 #include <aoc/aoc.h>
 #include <aoc/mem.h>
 
@@ -106,131 +107,110 @@ static const tool validTools[][2] = {
 
 typedef struct {
   point position;
-  point previous;
   tool tool;
-  int timer;
-} bfs_data;
+  int time;
+  int estimate;
+} search_node;
 
-static inline int bfs_data_compare(const bfs_data *const a,
-                                   const bfs_data *const b) {
-  return a->timer - b->timer;
+static inline int search_node_compare(const search_node *const a,
+                                      const search_node *const b) {
+  return a->estimate - b->estimate;
 }
 
-#define AOC_T bfs_data
-#define AOC_T_NAME BfsData
-#define AOC_T_COMPARE bfs_data_compare
+#define AOC_T search_node
+#define AOC_T_NAME SearchNode
+#define AOC_T_COMPARE search_node_compare
 #include <aoc/heap.h>
 
-static inline uint32_t bfs_data_hash(const bfs_data *const d) {
-  return 47254019u ^ (((*(uint32_t *)&d->position.x) * 84560501u) ^
-                      ((*(uint32_t *)&d->position.y) * 57798941u) ^
-                      ((*(uint32_t *)&d->tool) * 37853173u));
+static inline int fast_abs(const int n) {
+  const int mask = n >> (sizeof(int) * CHAR_BIT - 1);
+  return (n + mask) ^ mask;
 }
 
-static inline bool bfs_data_equals(const bfs_data *const a,
-                                   const bfs_data *const b) {
-  return a->position.x == b->position.x && a->position.y == b->position.y &&
-         a->tool == b->tool;
+static inline int manhattan_distance(const point a, const point b) {
+  return fast_abs(a.x - b.x) + fast_abs(a.y - b.y);
 }
 
-static const bfs_data emptyBfsData = {.position = {INT32_MIN, INT32_MIN},
-                                      .timer = -1};
-
-#define AOC_T bfs_data
-#define AOC_T_NAME BfsData
-#define AOC_T_HFUNC bfs_data_hash
-#define AOC_T_EQUALS bfs_data_equals
-#define AOC_T_EMPTY emptyBfsData
-#define AOC_BASE2_CAPACITY
-#include <aoc/hashset.h>
-
-static void get_adjacent(const bfs_data *const current,
-                         bfs_data adjacent[const 12],
-                         uint8_t *const adjacentCount, const map *const m) {
-  *adjacentCount = 0;
-  const point adjacentPoints[4] = {
-      {current->position.x - 1, current->position.y + 0},
-      {current->position.x + 1, current->position.y + 0},
-      {current->position.x + 0, current->position.y + 1},
-      {current->position.x + 0, current->position.y - 1},
-  };
+typedef struct {
+  AocMinHeapSearchNode open;
+  // fastest known time for every tile and tool combination
+  int *times;
+  point target;
+} search;
 
-  const tile currentTile =
-      m->tiles[current->position.y * m->width + current->position.x];
-  for (uint8_t i = 0; i < 4; ++i) {
-    point p = adjacentPoints[i];
-    if (p.x < 0 || p.y < 0 ||
-        (p.x == current->previous.x && p.y == current->previous.y))
-      continue;
-    tile mapTile = m->tiles[p.y * m->width + p.x];
+static inline size_t state_index(const map *const m, const point p,
+                                 const tool t) {
+  return ((size_t)p.y * (size_t)m->width + (size_t)p.x) * 3 + (size_t)t;
+}
 
-    for (tool t = 0; t < 3; ++t) {
-      if (!IS_VALID_TOOL(mapTile.type, t) ||
-          !IS_VALID_TOOL(currentTile.type, t))
-        continue;
-      bfs_data data = {
-          .position = p,
-          .timer = t == current->tool ? 1 : 8,
-          .tool = t,
-          .previous = current->position,
-      };
-      adjacent[(*adjacentCount)++] = data;
-    }
-  }
+static void try_push(search *const s, const map *const m, const point p,
+                     const tool t, const int time) {
+  const size_t index = state_index(m, p, t);
+  if (time >= s->times[index])
+    return;
+  s->times[index] = time;
+  // the distance never overestimates the remaining time which makes it a
+  // valid A* heuristic
+  const search_node node = {
+      .position = p,
+      .tool = t,
+      .time = time,
+      .estimate = time + manhattan_distance(p, s->target),
+  };
+  AocMinHeapSearchNodePush(&s->open, node);
 }
 
 static int solve_part2(const context *const ctx, const map *const m) {
-  AocMinHeapBfsData current = {0};
-  AocHashsetBfsData visited = {0};
-
-  AocMinHeapBfsDataCreate(&current, 1 << 15);
-  AocHashsetBfsDataCreate(&visited, 1 << 21);
-
-  bfs_data start = {.position = {0, 0}, .timer = 0, .tool = TOOL_TORCH};
-  AocMinHeapBfsDataPush(&current, start);
-
-  bfs_data adjacent[12] = {0};
-  uint8_t adjacentCount = 0;
-  int time = 0;
+  const size_t stateCount = (size_t)m->width * (size_t)m->height * 3;
+  search s = {.target = ctx->target};
+  s.times = AocAlloc(sizeof(int) * stateCount);
+  for (size_t i = 0; i < stateCount; ++i)
+    s.times[i] = INT_MAX;
+  AocMinHeapSearchNodeCreate(&s.open, 1 << 15);
+
+  try_push(&s, m, (point){0, 0}, TOOL_TORCH, 0);
+
+  int result = -1;
+  while (s.open.count > 0) {
+    const search_node current = AocMinHeapSearchNodePop(&s.open);
+    // skip entries which were pushed before a faster way was found
+    if (current.time > s.times[state_index(m, current.position, current.tool)])
+      continue;
 
-  while (current.count > 0) {
-    bfs_data b;
-    while (AocMinHeapBfsDataPeek(&current).timer == 0) {
-      b = AocMinHeapBfsDataPop(&current);
+    if (current.position.x == ctx->target.x &&
+        current.position.y == ctx->target.y && current.tool == TOOL_TORCH) {
+      result = current.time;
+      break;
+    }
 
-      uint32_t hash = 0;
-      if (!AocHashsetBfsDataContains(&visited, b, &hash))
-        AocHashsetBfsDataInsertPreHashed(&visited, b, hash);
-      else
+    // switch to the other tool which is valid in the current region
+    const tile_type type =
+        m->tiles[current.position.y * m->width + current.position.x].type;
+    const tool other = validTools[type][0] == current.tool
+                           ? validTools[type][1]
+                           : validTools[type][0];
+    try_push(&s, m, current.position, other, current.time + 7);
+
+    // move with the current tool
+    const point adjacent[4] = {
+        {current.position.x - 1, current.position.y + 0},
+        {current.position.x + 1, current.position.y + 0},
+        {current.position.x + 0, current.position.y + 1},
+        {current.position.x + 0, current.position.y - 1},
+    };
+    for (uint8_t i = 0; i < 4; ++i) {
+      const point p = adjacent[i];
+      if (p.x < 0 || p.y < 0 || p.x >= m->width || p.y >= m->height)
         continue;
-
-      if (b.position.x == ctx->target.x && b.position.y == ctx->target.y) {
-        if (b.tool != TOOL_TORCH) {
-          b.tool = TOOL_TORCH;
-          b.timer = 7;
-          AocMinHeapBfsDataPush(&current, b);
-          continue;
-        }
-        goto done;
-      }
-
-      get_adjacent(&b, adjacent, &adjacentCount, m);
-      for (uint8_t i = 0; i < adjacentCount; ++i) {
-        AocMinHeapBfsDataPush(&current, adjacent[i]);
-      }
+      const tile_type adjacentType = m->tiles[p.y * m->width + p.x].type;
+      if (IS_VALID_TOOL(adjacentType, current.tool))
+        try_push(&s, m, p, current.tool, current.time + 1);
     }
-
-    for (size_t i = 0; i < current.count; ++i)
-      current.items[i].timer--;
-
-    time++;
   }
 
-done:
-  AocMinHeapBfsDataDestroy(&current);
-  AocHashsetBfsDataDestroy(&visited);
-
-  return time;
+  AocMinHeapSearchNodeDestroy(&s.open);
+  AocFree(s.times);
+  return result;
 }
 
 int main(void) {
@@ -2,32 +2,27 @@
 #include <stdlib.h>
 #include <limits.h>
 #include <aoc/aoc.h>
+#include <aoc/mem.h>
 
-typedef struct {
-  int x, y, z;
-} point;
+#define AOC_T int
+#define AOC_T_NAME Int
+#include <aoc/array.h>
 
+// one column per field so the loops over all bots read contiguous memory
 typedef struct {
-  point position;
-  int radius;
-} nanobot;
-
-#define AOC_T nanobot
-#define AOC_T_NAME Bot
-#include <aoc/array.h>
+  AocArrayInt x;
+  AocArrayInt y;
+  AocArrayInt z;
+  AocArrayInt radius;
+} nanobots;
 
 static void parse(char *line, size_t length, void *userData) {
   (void)length;
-  nanobot b = {0};
-  b.position.x = strtol(line + 5, &line, 10);
-  b.position.y = strtol(line + 1, &line, 10);
-  b.position.z = strtol(line + 1, &line, 10);
-  b.radius = strtol(line + 5, NULL, 10);
-  AocArrayBotPush(userData, b);
-}
-
-static inline int compare_bots(const void *const a, const void *const b) {
-  return ((nanobot *)b)->radius - ((nanobot *)a)->radius;
+  nanobots *const bots = userData;
+  AocArrayIntPush(&bots->x, strtol(line + 5, &line, 10));
+  AocArrayIntPush(&bots->y, strtol(line + 1, &line, 10));
+  AocArrayIntPush(&bots->z, strtol(line + 1, &line, 10));
+  AocArrayIntPush(&bots->radius, strtol(line + 5, NULL, 10));
 }
 
 static inline int fast_abs(const int n) {
@@ -35,20 +30,43 @@ static inline int fast_abs(const int n) {
   return (n + mask) ^ mask;
 }
 
-static inline int manhattan_distance(const point a, const point b) {
-  return fast_abs(a.x - b.x) + fast_abs(a.y - b.y) + fast_abs(a.z - b.z);
+// compile hot loops for several instruction sets. the loader picks the best
+// one for the running cpu, so one binary can still use wide vectors
+#if defined(__x86_64__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define MULTIVERSION __attribute__((target_clones("avx2", "sse4.2", "default")))
+#endif
+#endif
+#ifndef MULTIVERSION
+#define MULTIVERSION
+#endif
+
+MULTIVERSION
+static int count_in_range(const int *const x, const int *const y,
+                          const int *const z, const size_t count, const int sx,
+                          const int sy, const int sz, const int r) {
+  int inRange = 0;
+  for (size_t i = 0; i < count; ++i)
+    inRange +=
+        fast_abs(x[i] - sx) + fast_abs(y[i] - sy) + fast_abs(z[i] - sz) <= r;
+  return inRange;
 }
 
-static int solve_part1(AocArrayBot *const bots) {
-  // assume bots are sorted in descending order (radius)
-  nanobot strongest = bots->items[0];
-  int inRange = 1;
-  for (size_t i = 1; i < bots->length; ++i) {
-    if (manhattan_distance(strongest.position, bots->items[i].position) <=
-        strongest.radius)
-      inRange++;
+static int solve_part1(const nanobots *const bots) {
+  const int *const radius = bots->radius.items;
+  size_t strongest = 0;
+  for (size_t i = 1; i < bots->radius.length; ++i) {
+    if (radius[i] > radius[strongest])
+      strongest = i;
   }
-  return inRange;
+
+  const int *const x = bots->x.items;
+  const int *const y = bots->y.items;
+  const int *const z = bots->z.items;
+
+  // the strongest bot is in range of itself
+  return count_in_range(x, y, z, bots->x.length, x[strongest], y[strongest],
+                        z[strongest], radius[strongest]);
 }
 
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
@@ -58,45 +76,50 @@ typedef struct {
   int e;
 } distance;
 
-static inline int compare_distance(const distance *const a,
-                                   const distance *const b) {
-  return a->value - b->value;
+static int compare_distance(const void *const a, const void *const b) {
+  const distance *const left = a;
+  const distance *const right = b;
+  // ranges end before others start at the same distance
+  if (left->value != right->value)
+    return left->value < right->value ? -1 : 1;
+  return left->e - right->e;
 }
 
-#define AOC_T distance
-#define AOC_T_NAME Dist
-#define AOC_T_COMPARE compare_distance
-#include <aoc/heap.h>
-
-static int solve_part2(AocArrayBot *const bots) {
-  AocMinHeapDist heap = {0};
-  AocMinHeapDistCreate(&heap, bots->length * 2);
-  for (size_t i = 0; i < bots->length; ++i) {
-    const nanobot b = bots->items[i];
-    const int d = manhattan_distance(b.position, (point){0});
-    AocMinHeapDistPush(&heap, (distance){MAX(0, d - b.radius), 1});
-    AocMinHeapDistPush(&heap, (distance){d + b.radius + 1, -1});
+static int solve_part2(const nanobots *const bots) {
+  // all events are known up front, so they are collected and sorted once
+  // instead of being pushed into a heap one by one
+  const size_t count = bots->x.length * 2;
+  distance *const events = AocAlloc(sizeof(distance) * count);
+  for (size_t i = 0; i < bots->x.length; ++i) {
+    const int d = fast_abs(bots->x.items[i]) + fast_abs(bots->y.items[i]) +
+                  fast_abs(bots->z.items[i]);
+    const int r = bots->radius.items[i];
+    events[i * 2 + 0] = (distance){MAX(0, d - r), 1};
+    events[i * 2 + 1] = (distance){d + r + 1, -1};
   }
-  int count = 0;
-  int maxCount = 0;
+  qsort(events, count, sizeof(distance), compare_distance);
+
+  int inRange = 0;
+  int maxInRange = 0;
   int result = 0;
-  while (heap.count > 0) {
-    distance d = AocMinHeapDistPop(&heap);
-    count += d.e;
-    if (count > maxCount) {
-      result = d.value;
-      maxCount = count;
+  for (size_t i = 0; i < count; ++i) {
+    inRange += events[i].e;
+    if (inRange > maxInRange) {
+      result = events[i].value;
+      maxInRange = inRange;
     }
   }
-  AocMinHeapDistDestroy(&heap);
+  AocFree(events);
   return result;
 }
 
 int main(void) {
-  AocArrayBot bots = {0};
-  AocArrayBotCreate(&bots, 1 << 12);
+  nanobots bots = {0};
+  AocArrayIntCreate(&bots.x, 1 << 10);
+  AocArrayIntCreate(&bots.y, 1 << 10);
+  AocArrayIntCreate(&bots.z, 1 << 10);
+  AocArrayIntCreate(&bots.radius, 1 << 10);
   AocReadFileLineByLine("day23/input.txt", parse, &bots);
-  qsort(bots.items, bots.length, sizeof(nanobot), compare_bots);
 
   const int part1 = solve_part1(&bots);
   const int part2 = solve_part2(&bots);
@@ -104,5 +127,8 @@ int main(void) {
   printf("%d\n", part1);
   printf("%d\n", part2);
 
-  AocArrayBotDestroy(&bots);
+  AocArrayIntDestroy(&bots.x);
+  AocArrayIntDestroy(&bots.y);
+  AocArrayIntDestroy(&bots.z);
+  AocArrayIntDestroy(&bots.radius);
 }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <aoc/aoc.h>
+#include "../common/sort.h"
 
 typedef enum {
   DAMAGE_TYPE_NONE = 0,
@@ -123,21 +124,22 @@ static inline int64_t effective_power(const group *const g) {
   return (int64_t)g->units * (int64_t)g->ap;
 }
 
-static inline int compare_group_by_effective_power(const void *const a,
-                                                   const void *const b) {
+static inline int compare_group_by_effective_power(const group *const a,
+                                                   const group *const b) {
   const int diff = effective_power(b) - effective_power(a);
-  return diff == 0 ? ((group *)b)->init - ((group *)a)->init : diff;
+  return diff == 0 ? b->init - a->init : diff;
 }
 
-static inline int compare_group_by_init(const void *const a,
-                                        const void *const b) {
-  return ((group *)b)->init - ((group *)a)->init;
+static inline int compare_group_ptr_by_init(group *const *const a,
+                                            group *const *const b) {
+  return (*b)->init - (*a)->init;
 }
 
-static inline int compare_group_ptr_by_init(const void *const a,
-                                            const void *const b) {
-  return compare_group_by_init(*(group **)a, *(group **)b);
-}
+// the order only changes when groups lose units, so the arrays are almost
+// sorted every round
+AOC_DEFINE_INSERTION_SORT(group, Groups, compare_group_by_effective_power)
+
+AOC_DEFINE_INSERTION_SORT(group *, GroupPtrs, compare_group_ptr_by_init)
 
 #define HAS_FLAG(flags, flag) (((flags) & (flag)) == (flag))
 
@@ -200,11 +202,9 @@ static bool simulate(context *const ctx, const int boost,
   }
 
   while (immuneUnitsCount > 0 && infectionUnitsCount > 0) {
-    qsort(ctx->immuneSystem.items, ctx->immuneSystem.length, sizeof(group),
-          compare_group_by_effective_power);
-    qsort(ctx->infection.items, ctx->infection.length, sizeof(group),
-          compare_group_by_effective_power);
-    qsort(groups, count, sizeof(group *), compare_group_ptr_by_init);
+    AocInsertionSortGroups(ctx->immuneSystem.items, ctx->immuneSystem.length);
+    AocInsertionSortGroups(ctx->infection.items, ctx->infection.length);
+    AocInsertionSortGroupPtrs(groups, count);
 
     // selection phase
     select_targets(&ctx->immuneSystem, &ctx->infection);
@@ -2,6 +2,8 @@
 #include <stdio.h>
 #include <limits.h>
 #include <aoc/aoc.h>
+#include <aoc/mem.h>
+#include "../common/dsu.h"
 
 typedef struct {
   int x, y, z, w;
@@ -11,17 +13,11 @@ typedef struct {
 #define AOC_T_NAME Point
 #include <aoc/array.h>
 
-typedef struct {
-  AocArrayPoint points;
-} constellation;
-
-#define AOC_T constellation
-#define AOC_T_NAME Constellations
+#define AOC_T uint32_t
+#define AOC_T_NAME U32
 #include <aoc/array.h>
 
-#define AOC_T size_t
-#define AOC_T_NAME Index
-#include <aoc/array.h>
+AOC_DEFINE_DSU(uint32_t, U32)
 
 static void parse(char *line, size_t length, void *userData) {
   (void)length;
@@ -43,57 +39,101 @@ static inline int manhattan_distance(const point a, const point b) {
          fast_abs(a.w - b.w);
 }
 
+#define MAX_DISTANCE 3
+
+// points are put into a uniform grid with cells as wide as the max distance.
+// all points in range of a point are then in the same or a neighbouring cell
+typedef struct {
+  uint64_t cell;
+  size_t index;
+} grid_entry;
+
+static inline int cell_coordinate(const int n) {
+  // round towards negative infinity so negative coordinates get their own
+  // cells
+  return n >= 0 ? n / MAX_DISTANCE : (n - (MAX_DISTANCE - 1)) / MAX_DISTANCE;
+}
+
+static inline uint64_t cell_key(const int x, const int y, const int z,
+                                const int w) {
+  return ((uint64_t)(uint16_t)x << 48) | ((uint64_t)(uint16_t)y << 32) |
+         ((uint64_t)(uint16_t)z << 16) | (uint64_t)(uint16_t)w;
+}
+
+static int compare_grid_entries(const void *const a, const void *const b) {
+  const uint64_t left = ((const grid_entry *)a)->cell;
+  const uint64_t right = ((const grid_entry *)b)->cell;
+  return (left > right) - (left < right);
+}
+
+static size_t find_first_in_cell(const grid_entry *const entries,
+                                 const size_t count, const uint64_t cell) {
+  size_t low = 0;
+  size_t high = count;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    if (entries[mid].cell < cell)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return low;
+}
+
 static size_t solve(const AocArrayPoint *const points) {
-  AocArrayConstellations constellations = {0};
-  AocArrayConstellationsCreate(&constellations, 1 << 8);
-  AocArrayIndex indices = {0};
-  AocArrayIndexCreate(&indices, 1 << 8);
-
-  for (size_t i = 0; i < points->length; ++i) {
-    AocArrayIndexClear(&indices);
-    for (size_t j = 0; j < constellations.length; ++j) {
-      bool found = false;
-      for (size_t k = 0; k < constellations.items[j].points.length; ++k) {
-        point p = constellations.items[j].points.items[k];
-        if (manhattan_distance(p, points->items[i]) <= 3) {
-          found = true;
-          break;
+  const size_t count = points->length;
+  grid_entry *const grid = AocAlloc(sizeof(grid_entry) * count);
+  for (size_t i = 0; i < count; ++i) {
+    const point p = points->items[i];
+    grid[i] = (grid_entry){
+        .cell = cell_key(cell_coordinate(p.x), cell_coordinate(p.y),
+                         cell_coordinate(p.z), cell_coordinate(p.w)),
+        .index = i,
+    };
+  }
+  qsort(grid, count, sizeof(grid_entry), compare_grid_entries);
+
+  // pairs of points which are close enough to be in the same constellation
+  AocArrayU32 from = {0};
+  AocArrayU32 to = {0};
+  AocArrayU32Create(&from, 1 << 12);
+  AocArrayU32Create(&to, 1 << 12);
+
+  for (size_t i = 0; i < count; ++i) {
+    const point p = points->items[i];
+    const int x = cell_coordinate(p.x);
+    const int y = cell_coordinate(p.y);
+    const int z = cell_coordinate(p.z);
+    const int w = cell_coordinate(p.w);
+
+    // visit all 3^4 cells around the point's cell
+    for (int n = 0; n < 81; ++n) {
+      const uint64_t cell = cell_key(x + n % 3 - 1, y + n / 3 % 3 - 1,
+                                     z + n / 9 % 3 - 1, w + n / 27 - 1);
+      for (size_t j = find_first_in_cell(grid, count, cell);
+           j < count && grid[j].cell == cell; ++j) {
+        const size_t other = grid[j].index;
+        if (other > i &&
+            manhattan_distance(p, points->items[other]) <= MAX_DISTANCE) {
+          AocArrayU32Push(&from, (uint32_t)i);
+          AocArrayU32Push(&to, (uint32_t)other);
         }
       }
-      if (found) {
-        AocArrayIndexPush(&indices, j);
-      }
-    }
-    if (indices.length == 0) {
-      constellation c = {0};
-      AocArrayPointCreate(&c.points, 1 << 6);
-      AocArrayPointPush(&c.points, points->items[i]);
-      AocArrayConstellationsPush(&constellations, c);
-    } else if (indices.length == 1) {
-      AocArrayPointPush(&constellations.items[indices.items[0]].points,
-                        points->items[i]);
-    } else {
-      // merge constellations
-      constellation *const dest = &constellations.items[indices.items[0]];
-      AocArrayPointPush(&dest->points, points->items[i]);
-      for (size_t j = indices.length - 1; j > 0; --j) {
-        constellation *const src = &constellations.items[indices.items[j]];
-
-        for (size_t k = 0; k < src->points.length; ++k)
-          AocArrayPointPush(&dest->points, src->points.items[k]);
-
-        AocArrayPointDestroy(&src->points);
-        *src = constellations.items[constellations.length - 1];
-        constellations.length--;
-      }
     }
   }
 
-  for (size_t i = 0; i < constellations.length; ++i)
-    AocArrayPointDestroy(&constellations.items[i].points);
-  AocArrayIndexDestroy(&indices);
-  AocArrayConstellationsDestroy(&constellations);
-  return constellations.length;
+  // every point starts as its own constellation. joining two points which are
+  // close enough merges their constellations
+  AocDsuU32 constellations = {0};
+  AocDsuU32Create(&constellations, count);
+  AocDsuU32UnionBatch(&constellations, from.items, to.items, from.length);
+
+  const size_t constellationCount = constellations.count;
+  AocDsuU32Destroy(&constellations);
+  AocArrayU32Destroy(&to);
+  AocArrayU32Destroy(&from);
+  AocFree(grid);
+  return constellationCount;
 }
 
 int main(void) {